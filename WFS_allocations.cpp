@@ -0,0 +1,107 @@
+#include "WFS_allocations.h"
+
+#ifdef WILDLAND_FIRESIM_ALLOCATION_CHECK
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace wildland_firesim {
+namespace allocations {
+namespace {
+
+//constant initialized, so they can be used before the thread's objects are constructed. The count is
+//shared by all threads: the work of a scope may be handed to the threads of a scheduler, which open
+//scopes of their own.
+thread_local int scopeDepth = 0;
+std::atomic<long long> allocationCount{0};
+
+void *
+allocate(std::size_t size)
+{
+    if(scopeDepth > 0){
+        allocationCount.fetch_add(1, std::memory_order_relaxed);
+    }
+    return std::malloc(size == 0 ? 1 : size);
+}
+
+}
+
+Scope::Scope()
+{
+    scopeDepth++;
+}
+
+Scope::~Scope()
+{
+    scopeDepth--;
+}
+
+long long
+countInScopes()
+{
+    return allocationCount.load();
+}
+
+void
+resetCount()
+{
+    allocationCount.store(0);
+}
+
+}  // namespace allocations
+}  // namespace wildland_firesim
+
+void *
+operator new(std::size_t size)
+{
+    void *memory = wildland_firesim::allocations::allocate(size);
+    if(!memory){
+        throw std::bad_alloc();
+    }
+    return memory;
+}
+
+void *
+operator new[](std::size_t size)
+{
+    return operator new(size);
+}
+
+void *
+operator new(std::size_t size, const std::nothrow_t &) noexcept
+{
+    return wildland_firesim::allocations::allocate(size);
+}
+
+void *
+operator new[](std::size_t size, const std::nothrow_t &) noexcept
+{
+    return wildland_firesim::allocations::allocate(size);
+}
+
+void
+operator delete(void *memory) noexcept
+{
+    std::free(memory);
+}
+
+void
+operator delete[](void *memory) noexcept
+{
+    std::free(memory);
+}
+
+void
+operator delete(void *memory, const std::nothrow_t &) noexcept
+{
+    std::free(memory);
+}
+
+void
+operator delete[](void *memory, const std::nothrow_t &) noexcept
+{
+    std::free(memory);
+}
+
+#endif // WILDLAND_FIRESIM_ALLOCATION_CHECK
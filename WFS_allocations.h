@@ -0,0 +1,50 @@
+#ifndef WILDLAND_FIRESIM_ALLOCATIONS_H
+#define WILDLAND_FIRESIM_ALLOCATIONS_H
+
+/*!
+ * Counting of heap allocations within marked scopes, e.g. a timestep of the spread engine, which
+ * should only use memory kept from earlier timesteps. It is compiled in with the CMake option
+ * WILDLAND_FIRESIM_ALLOCATION_CHECK only, which replaces the global operator new; otherwise the macro
+ * below expands to nothing.
+ */
+#ifdef WILDLAND_FIRESIM_ALLOCATION_CHECK
+#define WILDLAND_ALLOCATION_SCOPE() \
+    wildland_firesim::allocations::Scope wildlandAllocationScope
+#else
+#define WILDLAND_ALLOCATION_SCOPE()
+#endif
+
+#ifdef WILDLAND_FIRESIM_ALLOCATION_CHECK
+
+namespace wildland_firesim {
+namespace allocations {
+
+/*!
+ * \brief The Scope class
+ * counts the heap allocations of the calling thread while it exists. Scopes may be nested. Work of a
+ * scope run by other threads, e.g. the bodies of a parallel loop, needs a scope on those threads.
+ */
+class Scope
+{
+public:
+    Scope();
+    ~Scope();
+
+    Scope(const Scope &) = delete;
+    Scope &operator=(const Scope &) = delete;
+};
+
+/*!
+ * \brief countInScopes
+ * \return heap allocations of all threads within scopes since the last resetCount
+ */
+long long countInScopes();
+
+void resetCount();
+
+}  // namespace allocations
+}  // namespace wildland_firesim
+
+#endif // WILDLAND_FIRESIM_ALLOCATION_CHECK
+
+#endif // WILDLAND_FIRESIM_ALLOCATIONS_H
@@ -0,0 +1,81 @@
+#include "WFS_arena.h"
+#include <algorithm>
+#include <cstdint>
+
+namespace wildland_firesim {
+
+MonotonicArena::MonotonicArena(std::size_t blockSize) :
+    m_blockSize(blockSize), m_blocks(), m_currentBlock(0), m_offset(0)
+{
+
+}
+
+MonotonicArena::MonotonicArena(const MonotonicArena &other) :
+    m_blockSize(other.m_blockSize), m_blocks(), m_currentBlock(0), m_offset(0)
+{
+
+}
+
+MonotonicArena &
+MonotonicArena::operator=(const MonotonicArena &other)
+{
+    if(this != &other){
+        m_blockSize = other.m_blockSize;
+        m_blocks.clear();
+        m_currentBlock = 0;
+        m_offset = 0;
+    }
+    return *this;
+}
+
+void *
+MonotonicArena::allocateBytes(std::size_t bytes, std::size_t alignment)
+{
+    while(m_currentBlock < m_blocks.size()){
+        Block &block = m_blocks[m_currentBlock];
+        std::uintptr_t begin = reinterpret_cast<std::uintptr_t>(block.memory.get());
+        std::size_t offset = ((begin + m_offset + alignment - 1) & ~(alignment - 1)) - begin;
+        if(offset + bytes <= block.size){
+            m_offset = offset + bytes;
+            return block.memory.get() + offset;
+        }
+        //the remainder of a block is left unused until the next reset
+        m_currentBlock++;
+        m_offset = 0;
+    }
+
+    //new blocks at least double the capacity, so a growing demand needs few of them
+    Block block;
+    block.size = std::max(std::max(m_blockSize, getCapacity()), bytes + alignment);
+    block.memory.reset(new unsigned char[block.size]);
+    m_blocks.push_back(std::move(block));
+    m_currentBlock = m_blocks.size() - 1;
+    m_offset = 0;
+    return allocateBytes(bytes, alignment);
+}
+
+void
+MonotonicArena::reset()
+{
+    if(m_blocks.size() > 1){
+        Block block;
+        block.size = getCapacity();
+        block.memory.reset(new unsigned char[block.size]);
+        m_blocks.clear();
+        m_blocks.push_back(std::move(block));
+    }
+    m_currentBlock = 0;
+    m_offset = 0;
+}
+
+std::size_t
+MonotonicArena::getCapacity() const noexcept
+{
+    std::size_t capacity = 0;
+    for(const auto &block : m_blocks){
+        capacity += block.size;
+    }
+    return capacity;
+}
+
+}  // namespace wildland_firesim
@@ -0,0 +1,76 @@
+#ifndef WILDLAND_FIRESIM_ARENA_H
+#define WILDLAND_FIRESIM_ARENA_H
+
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+namespace wildland_firesim {
+
+/*!
+ * \brief The MonotonicArena class
+ * hands out buffers of trivially destructible objects which are all released at once by reset. The
+ * memory is kept across resets: when a reset follows a period that needed more than one block, the blocks
+ * are replaced by one block of their total size, so a recurring demand is served from a single block
+ * without calling the allocator again.
+ */
+class MonotonicArena
+{
+public:
+    /*!
+     * \brief MonotonicArena
+     * \param blockSize size of the first block in bytes, allocated when first needed
+     */
+    explicit MonotonicArena(std::size_t blockSize = 64 * 1024);
+
+    /*!
+     * \brief MonotonicArena
+     * a copy holds no buffers, e.g. of a copied Fire: they are only valid until the next reset anyway.
+     */
+    MonotonicArena(const MonotonicArena &other);
+    MonotonicArena &operator=(const MonotonicArena &other);
+
+    /*!
+     * \brief allocate
+     * \param count
+     * \return uninitialized storage for count objects, valid until the next reset
+     */
+    template<typename T>
+    T *allocate(std::size_t count)
+    {
+        static_assert(std::is_trivially_destructible<T>::value,
+                      "objects in a MonotonicArena are never destroyed");
+        return static_cast<T *>(allocateBytes(count * sizeof(T), alignof(T)));
+    }
+
+    /*!
+     * \brief reset
+     * releases all buffers handed out since the previous reset.
+     */
+    void reset();
+
+    /*!
+     * \brief getCapacity
+     * \return bytes held by the arena
+     */
+    std::size_t getCapacity() const noexcept;
+
+private:
+    struct Block {
+        std::unique_ptr<unsigned char[]> memory;
+        std::size_t size;
+    };
+
+    std::size_t m_blockSize;
+    std::vector<Block> m_blocks;
+    //block and offset in it of the next buffer
+    std::size_t m_currentBlock;
+    std::size_t m_offset;
+
+    void *allocateBytes(std::size_t bytes, std::size_t alignment);
+};
+
+}  // namespace wildland_firesim
+
+#endif // WILDLAND_FIRESIM_ARENA_H
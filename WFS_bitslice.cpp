@@ -0,0 +1,369 @@
+#include "WFS_bitslice.h"
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <math.h>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <unordered_map>
+#include "WFS_tracing.h"
+#include "utility.h"
+
+namespace wildland_firesim {
+namespace {
+
+constexpr int CellsBorderingVertex = 4;
+//spread directions of a cell ignited from each of the vertices bordering it, as in Fire
+constexpr int SpreadDirections[CellsBorderingVertex][CellInternSpreadDirectionsCount] = {{1,2,3},{3,4,5},{5,6,7},{7,8,1}};
+//vertex reached by each spread direction, relative to the vertex the cell was ignited from
+constexpr int DirectionOffsets[9][2] = {{0,0},{0,1},{1,1},{1,0},{1,-1},{0,-1},{-1,-1},{-1,0},{-1,1}};
+//vertex a cell is ignited from, relative to the cell, for each of the cells sharing a vertex
+constexpr int IgnitionVertexOffsets[CellsBorderingVertex][2] = {{0,0},{0,1},{1,1},{1,0}};
+
+//cell l of the cells sharing vertex (u, v) is ignited from the vertex with the spread directions l
+void
+cellAtVertex(int u, int v, int l, int *x, int *y)
+{
+    const int cellsBorderingVertex[CellsBorderingVertex][2] = {{u,v},{u,v-1},{u-1,v-1},{u-1,v}};
+    *x = cellsBorderingVertex[l][0];
+    *y = cellsBorderingVertex[l][1];
+}
+
+}
+
+/*!
+ * \brief The BitSlicedEnsemble::Pass struct
+ * state of the 64 fires of a pass. Fire m is bit m of the masks.
+ */
+struct BitSlicedEnsemble::Pass {
+    struct PointFireSource {
+        int u;
+        int v;
+        float fireIntensity;
+        int remainingTime;
+        std::uint64_t fires;
+    };
+
+    std::uint64_t members;
+    std::mt19937_64 random;
+    //fires in which each cell was ignited
+    std::vector<std::uint64_t> ignited;
+    std::vector<int> ignitedCells;
+    //vertices reached by burning cells at each timestep
+    std::vector<std::vector<PointFireSource>> sources;
+    size_t pendingSources;
+    int lastTimestep[NumberOfMembers];
+    //timings of the cells burned by the passes of a thread, by cell, vertex and time left over
+    std::unordered_map<std::uint64_t, CellTiming> timings;
+};
+
+BitSlicedEnsemble::BitSlicedEnsemble()
+    : m_width(0), m_height(0), m_cellSize(0.f), m_timestepLength(0), m_maxFireDuration(0), m_weather(),
+      m_burnCounts(), m_burnedCells(), m_durations(), m_fuelMoisture()
+{
+
+}
+
+void
+BitSlicedEnsemble::run(const LandscapeInterface &landscape, const FireWeatherVariables &weather,
+                       int timestepLength, int maxFireDuration, int numberOfFires, bool centeredIgnition,
+                       unsigned int seed, int numberOfThreads)
+{
+    WILDLAND_TRACE_SPAN("bitSlicedEnsemble");
+    m_width = landscape.getWidth();
+    m_height = landscape.getHeight();
+    m_cellSize = static_cast<float>(landscape.getCellSize());
+    m_timestepLength = timestepLength;
+    m_maxFireDuration = maxFireDuration;
+    m_weather = weather;
+    size_t numberOfCells = static_cast<size_t>(m_width) * m_height;
+    m_burnCounts.assign(numberOfCells, 0);
+    m_burnedCells.assign(static_cast<size_t>(numberOfFires), 0);
+    m_durations.assign(static_cast<size_t>(numberOfFires), 0.f);
+
+    //fuel moisture of the grass cells, as in Fire::igniteCells
+    Fire fire;
+    fire.setFireWeather(weather);
+    m_fuelMoisture.assign(numberOfCells, 0.f);
+    for(int y = 0; y < m_height; y++)
+        for(int x = 0; x < m_width; x++){
+            const Cell *cell = landscape.getCellInformation(x, y);
+            if(cell->type != VegetationType::Grass) continue;
+            float fuelLoad = cell->liveBiomass + cell->deadBiomass;
+            m_fuelMoisture[static_cast<size_t>(y) * m_width + x] =
+                    fire.estimateGrassFuelMoisture(weather.temperature, weather.relHumidity,
+                                                   cell->deadBiomass / fuelLoad);
+        }
+
+    int numberOfPasses = (numberOfFires + NumberOfMembers - 1) / NumberOfMembers;
+    std::atomic<int> nextPass{0};
+    std::mutex resultMutex;
+    auto worker = [&]() {
+        Fire threadFire;
+        threadFire.setFireWeather(weather);
+        Pass pass;
+        pass.ignited.assign(numberOfCells, 0);
+        pass.sources.resize(static_cast<size_t>(std::max(maxFireDuration, 1)));
+        for(int i = nextPass++; i < numberOfPasses; i = nextPass++){
+            WILDLAND_TRACE_SPAN("bitSlicedPass");
+            int members = std::min(NumberOfMembers, numberOfFires - i * NumberOfMembers);
+            pass.members = members == NumberOfMembers ? ~std::uint64_t{0} : (std::uint64_t{1} << members) - 1;
+            pass.random.seed(utility::deriveSeed(seed, static_cast<unsigned int>(i)));
+            pass.pendingSources = 0;
+            std::fill(pass.lastTimestep, pass.lastTimestep + NumberOfMembers, 0);
+            burnPass(landscape, threadFire, pass, centeredIgnition);
+
+            for(int m = 0; m < members; m++){
+                m_durations[static_cast<size_t>(i * NumberOfMembers + m)] =
+                        (pass.lastTimestep[m] * timestepLength) / (60.f * 60.f);
+            }
+            std::lock_guard<std::mutex> lock{resultMutex};
+            for(int cell : pass.ignitedCells){
+                std::uint64_t fires = pass.ignited[static_cast<size_t>(cell)];
+                for(int m = 0; m < members; m++){
+                    if((fires >> m) & 1){
+                        m_burnCounts[static_cast<size_t>(cell)]++;
+                        m_burnedCells[static_cast<size_t>(i * NumberOfMembers + m)]++;
+                    }
+                }
+                pass.ignited[static_cast<size_t>(cell)] = 0;
+            }
+            pass.ignitedCells.clear();
+        }
+    };
+
+    numberOfThreads = std::max(1, std::min(numberOfThreads, numberOfPasses));
+    std::vector<std::thread> threads;
+    for(int i = 1; i < numberOfThreads; i++){
+        threads.emplace_back(worker);
+    }
+    worker();
+    for(auto &thread : threads){
+        thread.join();
+    }
+}
+
+void
+BitSlicedEnsemble::burnPass(const LandscapeInterface &landscape, Fire &fire, Pass &pass,
+                            bool centeredIgnition) const
+{
+    //the course of the cell is known from its timing: the vertices it reaches are scheduled and the
+    //fires burn until it burns out
+    auto ignite = [&](int cell, int vertex, int remainingTime, std::uint64_t fires, int timestep) {
+        if(pass.ignited[static_cast<size_t>(cell)] == 0){
+            pass.ignitedCells.push_back(cell);
+        }
+        pass.ignited[static_cast<size_t>(cell)] |= fires;
+        std::uint64_t key = (static_cast<std::uint64_t>(cell) * CellsBorderingVertex + vertex) *
+                static_cast<std::uint64_t>(m_timestepLength + 1) + static_cast<std::uint64_t>(remainingTime);
+        auto timing = pass.timings.find(key);
+        if(timing == pass.timings.end()){
+            const Cell *burningCell = landscape.getCellInformation(cell % m_width, cell / m_width);
+            timing = pass.timings.emplace(key, calculateTiming(fire, burningCell, vertex, remainingTime)).first;
+        }
+        const CellTiming &cellTiming = timing->second;
+
+        int u = cell % m_width + IgnitionVertexOffsets[vertex][0];
+        int v = cell / m_width + IgnitionVertexOffsets[vertex][1];
+        for(int k = 0; k < CellInternSpreadDirectionsCount; k++){
+            if(cellTiming.reachAge[k] == 0 || timestep + cellTiming.reachAge[k] >= m_maxFireDuration) continue;
+            const int *offset = DirectionOffsets[SpreadDirections[vertex][k]];
+            pass.sources[static_cast<size_t>(timestep + cellTiming.reachAge[k])].push_back(
+                        Pass::PointFireSource{u + offset[0], v + offset[1], cellTiming.firelineIntensity[k],
+                                              cellTiming.remainingTime[k], fires});
+            pass.pendingSources++;
+        }
+        int lastTimestep = m_maxFireDuration - 1;
+        if(cellTiming.burnOutAge != 0){
+            lastTimestep = std::min(lastTimestep, timestep + cellTiming.burnOutAge);
+        }
+        for(int m = 0; m < NumberOfMembers && (fires >> m) != 0; m++){
+            if((fires >> m) & 1){
+                pass.lastTimestep[m] = std::max(pass.lastTimestep[m], lastTimestep);
+            }
+        }
+    };
+
+    //ignition, each fire like Fire::initiateWildFire or Fire::setCenteredIgnitionPoint
+    std::uniform_int_distribution<int> randomU{0, m_width - 1};
+    std::uniform_int_distribution<int> randomV{0, m_height - 1};
+    std::uniform_real_distribution<float> randomProbability{0.f, 1.f};
+    for(int m = 0; m < NumberOfMembers; m++){
+        if(((pass.members >> m) & 1) == 0) continue;
+        int u = m_width / 2;
+        int v = m_height / 2;
+        if(!centeredIgnition){
+            u = randomU(pass.random);
+            v = randomV(pass.random);
+        }
+        for(int l = 0; l < CellsBorderingVertex; l++){
+            int x, y;
+            cellAtVertex(u, v, l, &x, &y);
+            if(x < 0 || x >= m_width || y < 0 || y >= m_height) continue;
+            const Cell *cell = landscape.getCellInformation(x, y);
+            if(cell->type != VegetationType::Grass) continue;
+            int index = y * m_width + x;
+            if(!centeredIgnition){
+                if(cell->deadBiomass + cell->liveBiomass < MinimumIgnitionFuelLoad) continue;
+                float probability = fire.calculateInitialIgnitionProbability(m_fuelMoisture[static_cast<size_t>(index)]);
+                if(!(randomProbability(pass.random) < probability)) continue;
+            }
+            ignite(index, l, 0, std::uint64_t{1} << m, 0);
+        }
+    }
+
+    //spread, ignition of the cells sharing the vertices reached as in Fire::igniteCells
+    for(int timestep = 1; pass.pendingSources > 0 && timestep < m_maxFireDuration; timestep++){
+        std::vector<Pass::PointFireSource> &sources = pass.sources[static_cast<size_t>(timestep)];
+        pass.pendingSources -= sources.size();
+        for(const auto &source : sources){
+            for(int l = 0; l < CellsBorderingVertex; l++){
+                int x, y;
+                cellAtVertex(source.u, source.v, l, &x, &y);
+                if(x < 0 || x >= m_width || y < 0 || y >= m_height) continue;
+                int index = y * m_width + x;
+                std::uint64_t candidates = source.fires & ~pass.ignited[static_cast<size_t>(index)];
+                if(candidates == 0) continue;
+                if(landscape.getCellInformation(x, y)->type != VegetationType::Grass) continue;
+                std::uint64_t fires = ignitionMask(fire, pass, candidates, source.fireIntensity,
+                                                   m_fuelMoisture[static_cast<size_t>(index)]);
+                if(fires){
+                    ignite(index, l, source.remainingTime, fires, timestep);
+                }
+            }
+        }
+        sources.clear();
+    }
+}
+
+BitSlicedEnsemble::CellTiming
+BitSlicedEnsemble::calculateTiming(Fire &fire, const Cell *cell, int vertex, int remainingTime) const
+{
+    Fire::burningCellInformation burningCell;
+    for(int k = 0; k < CellInternSpreadDirectionsCount; k++){
+        burningCell.spreadDirection[k] = SpreadDirections[vertex][k];
+    }
+    fire.updateSpreadCache(burningCell, cell);
+    float distanceToCellBoundary[CellInternSpreadDirectionsCount] = {m_cellSize, std::sqrt(2.f) * m_cellSize, m_cellSize};
+
+    CellTiming timing{};
+    float burnStatus[CellInternSpreadDirectionsCount];
+    for(int k = 0; k < CellInternSpreadDirectionsCount; k++){
+        burnStatus[k] = (burningCell.rateOfSpread[k] * remainingTime) / distanceToCellBoundary[k];
+        timing.firelineIntensity[k] = burningCell.firelineIntensity[k];
+    }
+    for(int age = 1; age < m_maxFireDuration; age++){
+        float sumIntensity = 0.0;
+        bool spreading = false;
+        for(int k = 0; k < CellInternSpreadDirectionsCount; k++){
+            float rateOfSpread = burningCell.rateOfSpread[k];
+            sumIntensity = sumIntensity + burningCell.firelineIntensity[k];
+            if(burnStatus[k] >= 1.f) continue;
+            float step = (rateOfSpread * m_timestepLength) / distanceToCellBoundary[k];
+            spreading = spreading || step > 0.f;
+            burnStatus[k] = step + burnStatus[k];
+            if(burnStatus[k] >= 1.f){
+                timing.reachAge[k] = age;
+                int leftOver = static_cast<int>(round(((burnStatus[k] - 1) * distanceToCellBoundary[k]) / rateOfSpread));
+                timing.remainingTime[k] = std::max(0, std::min(leftOver, m_timestepLength));
+                burnStatus[k] = 1.f;
+            }
+        }
+        float meanFirelineIntensity = sumIntensity / static_cast<size_t>(CellInternSpreadDirectionsCount);
+        float summarizedBurnStatus = 0.f;
+        for(int q = 0; q < CellInternSpreadDirectionsCount; q++){
+            summarizedBurnStatus = summarizedBurnStatus + burnStatus[q];
+        }
+        if(summarizedBurnStatus >= static_cast<size_t>(CellInternSpreadDirectionsCount) ||
+                meanFirelineIntensity <= 20.f){
+            timing.burnOutAge = age;
+            break;
+        }
+        //the remaining vertices are never reached
+        if(!spreading) break;
+    }
+    return timing;
+}
+
+std::uint64_t
+BitSlicedEnsemble::ignitionMask(Fire &fire, Pass &pass, std::uint64_t candidates, float intensity,
+                                float fuelMoisture) const
+{
+    float probability = fire.calculateCellIgnitionProbability(intensity, fuelMoisture);
+    if(!(probability > 0.f)) return 0;
+    if(probability >= 1.f) return candidates;
+    //a fire ignites if its random number, built from one random bit per word, is below the
+    //probability; most fires are decided after the first few bits
+    auto threshold = static_cast<std::uint32_t>(static_cast<double>(probability) * 4294967296.0);
+    std::uint64_t below = 0;
+    std::uint64_t equal = candidates;
+    for(int b = 31; b >= 0 && equal; b--){
+        std::uint64_t word = pass.random();
+        if((threshold >> b) & 1){
+            below |= equal & ~word;
+            equal &= word;
+        } else {
+            equal &= ~word;
+        }
+    }
+    return below;
+}
+
+int
+BitSlicedEnsemble::getNumberOfFires() const noexcept
+{
+    return static_cast<int>(m_burnedCells.size());
+}
+
+const std::vector<int> &
+BitSlicedEnsemble::getBurnCounts() const noexcept
+{
+    return m_burnCounts;
+}
+
+const std::vector<int> &
+BitSlicedEnsemble::getBurnedCells() const noexcept
+{
+    return m_burnedCells;
+}
+
+void
+BitSlicedEnsemble::writeBurnProbabilityToASCII(const std::string &fileName) const
+{
+    std::ofstream probabilityFile;
+    probabilityFile.open(fileName);
+
+    probabilityFile << "NCOLS " << m_width << std::endl;
+    probabilityFile << "NROWS " << m_height << std::endl;
+    probabilityFile << "XLLCORNER " << "0"  << std::endl;
+    probabilityFile << "YLLCORNER " << "0"  << std::endl;
+    probabilityFile << "CELLSIZE " << "1" << std::endl;
+    probabilityFile << "NODATA_VALUE " << "-9999" << std::endl;
+
+    for (int y = (m_height-1); y >= 0; y--)
+        for (int x = 0; x < m_width; x++) {
+            probabilityFile << static_cast<float>(m_burnCounts[static_cast<size_t>(y) * m_width + x]) /
+                               std::max(getNumberOfFires(), 1) << " ";
+        }
+    probabilityFile << "\n";
+    probabilityFile.close();
+}
+
+void
+BitSlicedEnsemble::writeSummaryToCSV(const std::string &fileName) const
+{
+    std::ofstream summaryFile;
+    summaryFile.open(fileName);
+    //header
+    summaryFile << "fire,burnedCells,burnedArea,duration" << "\n";
+    //data
+    for(size_t i = 0; i < m_burnedCells.size(); i++){
+        summaryFile << i << "," << m_burnedCells[i] << ",";
+        summaryFile << m_burnedCells[i] * m_cellSize * m_cellSize / 10000.f << ",";
+        summaryFile << m_durations[i] << "\n";
+    }
+    summaryFile.close();
+}
+
+}  // namespace wildland_firesim
@@ -0,0 +1,131 @@
+#ifndef WILDLAND_FIRESIM_BITSLICE_H
+#define WILDLAND_FIRESIM_BITSLICE_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "fire.h"
+#include "landscape_interface.h"
+
+namespace wildland_firesim {
+
+/*!
+ * \brief The BitSlicedEnsemble class
+ * is an experimental engine burning 64 fires of an ensemble at once on the same landscape under
+ * fixed fire weather. With fixed weather, when a burning cell reaches its vertices, the time
+ * left over for the next cells and when it burns out only depend on the cell, the vertex it was
+ * ignited from and the time left over by its source. These are calculated once per cell like in
+ * Fire and shared by all fires. Which fires a cell burns in is kept as the bits of a 64-bit word;
+ * the vertices the cell reaches are scheduled for all fires it was ignited in at once, and the
+ * ignitions at a vertex are decided for all fires reaching it by comparing random words with the
+ * bits of the ignition probability.
+ *
+ * A fire follows the rules of Fire, but is not identical to it: fires draw from other random
+ * numbers and ignite cells in another order, and a cell burns out as soon as its conditions are met
+ * (Fire may keep a burned out cell burning for another timestep). Burn probabilities and burned
+ * areas agree statistically.
+ */
+class BitSlicedEnsemble
+{
+public:
+    BitSlicedEnsemble();
+
+    /*!
+     * \brief run
+     * burns numberOfFires fires, 64 per pass, each ignited like Fire::initiateWildFire or at the
+     * central vertex. Passes are distributed over the threads; results do not depend on their number.
+     * \param landscape is not changed
+     * \param weather
+     * \param timestepLength in s
+     * \param maxFireDuration in timesteps
+     * \param numberOfFires
+     * \param centeredIgnition
+     * \param seed
+     * \param numberOfThreads
+     */
+    void run(const LandscapeInterface &landscape, const FireWeatherVariables &weather, int timestepLength,
+             int maxFireDuration, int numberOfFires, bool centeredIgnition, unsigned int seed,
+             int numberOfThreads);
+
+    int getNumberOfFires() const noexcept;
+
+    /*!
+     * \brief getBurnCounts
+     * \return number of fires in which each cell (row y at y * width) burned
+     */
+    const std::vector<int> &getBurnCounts() const noexcept;
+
+    /*!
+     * \brief getBurnedCells
+     * \return cells burned by each fire, cells still burning at the end count as burned
+     */
+    const std::vector<int> &getBurnedCells() const noexcept;
+
+    /*!
+     * \brief writeBurnProbabilityToASCII
+     * writes the fraction of fires in which each cell burned into an ascii-grid.
+     * \param fileName
+     */
+    void writeBurnProbabilityToASCII(const std::string &fileName) const;
+
+    /*!
+     * \brief writeSummaryToCSV
+     * writes burned cells, burned area and duration of each fire.
+     * \param fileName
+     */
+    void writeSummaryToCSV(const std::string &fileName) const;
+
+    static constexpr int NumberOfMembers = 64;
+
+private:
+    /*!
+     * \brief The CellTiming struct
+     * course of the fire of a cell ignited from one of its vertices with some time left over.
+     */
+    struct CellTiming {
+        //timestep after ignition at which each spread direction reaches its vertex, 0 if never
+        int reachAge[CellInternSpreadDirectionsCount];
+        //time left over when the vertex is reached in s
+        int remainingTime[CellInternSpreadDirectionsCount];
+        float firelineIntensity[CellInternSpreadDirectionsCount];
+        //timestep after ignition at which the cell burns out, 0 if never
+        int burnOutAge;
+    };
+
+    //fires of a pass, see the source file
+    struct Pass;
+
+    int m_width;
+    int m_height;
+    float m_cellSize;
+    int m_timestepLength;
+    int m_maxFireDuration;
+    FireWeatherVariables m_weather;
+    std::vector<int> m_burnCounts;
+    std::vector<int> m_burnedCells;
+    std::vector<float> m_durations;
+    std::vector<float> m_fuelMoisture;
+
+    /*!
+     * \brief calculateTiming
+     * follows the burn status of a cell like Fire::spreadWithinCells and Fire::burnOutCells.
+     */
+    CellTiming calculateTiming(Fire &fire, const Cell *cell, int vertex, int remainingTime) const;
+
+    /*!
+     * \brief burnPass
+     * burns the fires of a pass until none of them burns or the maximal fire duration is reached.
+     */
+    void burnPass(const LandscapeInterface &landscape, Fire &fire, Pass &pass, bool centeredIgnition) const;
+
+    /*!
+     * \brief ignitionMask
+     * \return the fires of candidates igniting a cell from a point fire source
+     */
+    std::uint64_t ignitionMask(Fire &fire, Pass &pass, std::uint64_t candidates, float intensity,
+                               float fuelMoisture) const;
+};
+
+}  // namespace wildland_firesim
+
+#endif // WILDLAND_FIRESIM_BITSLICE_H
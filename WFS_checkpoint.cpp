@@ -0,0 +1,310 @@
+#include "WFS_checkpoint.h"
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+namespace wildland_firesim {
+namespace {
+
+const char CheckpointFileMagic[8] = {'S', 'A', 'F', 'I', 'M', 'C', 'K', 'P'};
+constexpr std::uint32_t CheckpointFileVersion = 2;
+
+template<typename T>
+void
+writeValue(std::ostream &file, const T &value)
+{
+    file.write(reinterpret_cast<const char *>(&value), sizeof(T));
+}
+
+template<typename T>
+void
+writeVector(std::ostream &file, const std::vector<T> &values)
+{
+    writeValue(file, static_cast<std::uint64_t>(values.size()));
+    file.write(reinterpret_cast<const char *>(values.data()),
+               static_cast<std::streamsize>(values.size() * sizeof(T)));
+}
+
+//arrays are written like vectors, with their size in front
+template<typename T, std::size_t N>
+void
+writeArray(std::ostream &file, const T (&values)[N])
+{
+    writeValue(file, static_cast<std::uint64_t>(N));
+    writeValue(file, values);
+}
+
+template<typename T>
+bool
+readValue(std::istream &file, T *value)
+{
+    file.read(reinterpret_cast<char *>(value), sizeof(T));
+    return static_cast<bool>(file);
+}
+
+template<typename T>
+bool
+readVector(std::istream &file, std::vector<T> *values, std::uint64_t maximalSize)
+{
+    std::uint64_t size = 0;
+    if(!readValue(file, &size) || size > maximalSize){
+        return false;
+    }
+    values->resize(static_cast<size_t>(size));
+    file.read(reinterpret_cast<char *>(values->data()), static_cast<std::streamsize>(size * sizeof(T)));
+    return static_cast<bool>(file);
+}
+
+template<typename T, std::size_t N>
+bool
+readArray(std::istream &file, T (*values)[N])
+{
+    std::uint64_t size = 0;
+    return readValue(file, &size) && size == N && readValue(file, values);
+}
+
+void
+writeProgress(std::ostream &file, const SimulationProgress &progress)
+{
+    file.write(CheckpointFileMagic, sizeof(CheckpointFileMagic));
+    writeValue(file, CheckpointFileVersion);
+    writeValue(file, static_cast<std::int32_t>(progress.run));
+    writeValue(file, static_cast<std::int32_t>(progress.timestep));
+    writeValue(file, progress.durationOfBurn);
+    writeValue(file, static_cast<std::int32_t>(progress.weatherEpoch));
+    writeValue(file, static_cast<std::int32_t>(progress.timestepLength));
+}
+
+bool
+readProgress(std::istream &file, SimulationProgress *progress)
+{
+    char magic[sizeof(CheckpointFileMagic)];
+    std::uint32_t version = 0;
+    std::int32_t run, timestep, weatherEpoch, timestepLength;
+    float durationOfBurn;
+    file.read(magic, sizeof(magic));
+    if(!file || std::memcmp(magic, CheckpointFileMagic, sizeof(magic)) != 0 ||
+            !readValue(file, &version) || version != CheckpointFileVersion ||
+            !readValue(file, &run) || !readValue(file, &timestep) || !readValue(file, &durationOfBurn) ||
+            !readValue(file, &weatherEpoch) || !readValue(file, &timestepLength)){
+        return false;
+    }
+    progress->run = run;
+    progress->timestep = timestep;
+    progress->durationOfBurn = durationOfBurn;
+    progress->weatherEpoch = weatherEpoch;
+    progress->timestepLength = timestepLength;
+    return true;
+}
+
+}
+
+bool
+Checkpoint::write(const std::string &fileName, const SimulationProgress &progress,
+                  LandscapeInterface *landscape, const Fire &fire,
+                  const WeatherTimeline &weatherTimeline, const Output &output)
+{
+    std::string temporaryFileName = fileName + ".tmp";
+    {
+        std::ofstream file{temporaryFileName, std::ios::binary};
+        if(!file){
+            return false;
+        }
+        writeProgress(file, progress);
+        writeVector(file, fire.m_random->getState());
+
+        //cell states as runs of equal states row by row
+        std::int32_t width = landscape->getWidth();
+        std::int32_t height = landscape->getHeight();
+        writeValue(file, width);
+        writeValue(file, height);
+        std::uint32_t runLength = 0;
+        CellState runState = CellState::Unburned;
+        for(int y = 0; y < height; y++){
+            for(int x = 0; x < width; x++){
+                CellState state = landscape->getCellInformation(x, y)->getState(landscape->getStateEpoch());
+                if(state != runState && runLength > 0){
+                    writeValue(file, runLength);
+                    writeValue(file, static_cast<std::uint8_t>(runState));
+                    runLength = 0;
+                }
+                runState = state;
+                runLength++;
+            }
+        }
+        writeValue(file, runLength);
+        writeValue(file, static_cast<std::uint8_t>(runState));
+
+        //fire
+        writeValue(file, fire.m_weather);
+        writeValue(file, static_cast<std::int32_t>(fire.m_weatherEpoch));
+        writeValue(file, static_cast<std::int32_t>(fire.numberOfCellsBurning));
+        writeValue(file, static_cast<std::int32_t>(fire.statistics.numberOfCellsIgnited));
+        writeValue(file, static_cast<std::int32_t>(fire.statistics.numberOfCellsBurnedOut));
+        writeValue(file, fire.statistics.maximumFirelineIntensity);
+        writeValue(file, fire.statistics.sumOfFirelineIntensity);
+        //the front is sorted at the same timesteps as without the interruption
+        writeValue(file, static_cast<std::int32_t>(fire.m_timestepsSinceFrontSort));
+        writeValue(file, static_cast<std::uint64_t>(fire.burningCellInformationVector.size()));
+        for(const auto &burningCell : fire.burningCellInformationVector){
+            writeValue(file, static_cast<std::int32_t>(burningCell.xCoord));
+            writeValue(file, static_cast<std::int32_t>(burningCell.yCoord));
+            writeValue(file, static_cast<std::int32_t>(burningCell.uCoordSource));
+            writeValue(file, static_cast<std::int32_t>(burningCell.vCoordSource));
+            writeValue(file, burningCell.meanFirelineIntensity);
+            writeArray(file, burningCell.burnStatus);
+            writeArray(file, burningCell.spreadDirection);
+            writeValue(file, burningCell.rateOfSpread);
+            writeValue(file, burningCell.firelineIntensity);
+            writeValue(file, static_cast<std::int32_t>(burningCell.weatherEpoch));
+        }
+
+        //fire weather: the hours generated so far and the state of the weather simulation
+        writeVector(file, weatherTimeline.m_hourlyWeather);
+        const FireWeather *weatherSimulation = weatherTimeline.m_weatherSimulation;
+        writeValue(file, static_cast<std::uint8_t>(weatherSimulation != nullptr));
+        if(weatherSimulation){
+            writeValue(file, static_cast<std::uint8_t>(weatherSimulation->windyConditions));
+            writeValue(file, weatherSimulation->windSpeed);
+            writeValue(file, static_cast<std::int32_t>(weatherSimulation->windDirection));
+            writeValue(file, weatherSimulation->relHumidity);
+            writeValue(file, weatherSimulation->temperature);
+            writeValue(file, weatherSimulation->Tn);
+            writeValue(file, weatherSimulation->Tx);
+            writeValue(file, weatherSimulation->Tp);
+            writeValue(file, static_cast<std::int32_t>(weatherSimulation->startingTime));
+        }
+        writeValue(file, static_cast<std::uint64_t>(output.weatherData.size()));
+        for(const std::string &line : output.weatherData){
+            writeValue(file, static_cast<std::uint32_t>(line.size()));
+            file.write(line.data(), static_cast<std::streamsize>(line.size()));
+        }
+        if(!file.flush()){
+            return false;
+        }
+    }
+    return std::rename(temporaryFileName.c_str(), fileName.c_str()) == 0;
+}
+
+bool
+Checkpoint::readProgress(const std::string &fileName, SimulationProgress *progress)
+{
+    std::ifstream file{fileName, std::ios::binary};
+    return file && wildland_firesim::readProgress(file, progress);
+}
+
+bool
+Checkpoint::read(const std::string &fileName, SimulationProgress *progress,
+                 LandscapeInterface *landscape, Fire *fire,
+                 WeatherTimeline *weatherTimeline, Output *output)
+{
+    std::ifstream file{fileName, std::ios::binary};
+    if(!file || !wildland_firesim::readProgress(file, progress)){
+        return false;
+    }
+    std::vector<std::uint32_t> randomState;
+    if(!readVector(file, &randomState, 1 << 16) || !fire->m_random->setState(randomState)){
+        return false;
+    }
+
+    std::int32_t width, height;
+    if(!readValue(file, &width) || !readValue(file, &height) ||
+            width != landscape->getWidth() || height != landscape->getHeight()){
+        return false;
+    }
+    std::uint64_t numberOfCells = static_cast<std::uint64_t>(width) * height;
+    std::uint64_t cellIndex = 0;
+    CellBounds touchedBounds = CellBounds::none();
+    while(cellIndex < numberOfCells){
+        std::uint32_t runLength;
+        std::uint8_t state;
+        if(!readValue(file, &runLength) || !readValue(file, &state) || runLength == 0 ||
+                runLength > numberOfCells - cellIndex || state > static_cast<std::uint8_t>(CellState::BurnedOut)){
+            return false;
+        }
+        //the landscape is unburned, so only burning and burned-out cells have to be set
+        if(static_cast<CellState>(state) != CellState::Unburned){
+            for(std::uint64_t i = cellIndex; i < cellIndex + runLength; i++){
+                int x = static_cast<int>(i % width);
+                int y = static_cast<int>(i / width);
+                landscape->getCellInformation(x, y)->setState(static_cast<CellState>(state), landscape->getStateEpoch());
+                touchedBounds.include(x, y);
+            }
+        }
+        cellIndex += runLength;
+    }
+
+    std::int32_t weatherEpoch, numberOfCellsBurning, numberOfCellsIgnited, numberOfCellsBurnedOut;
+    std::int32_t timestepsSinceFrontSort;
+    std::uint64_t numberOfBurningCells;
+    if(!readValue(file, &fire->m_weather) || !readValue(file, &weatherEpoch) ||
+            !readValue(file, &numberOfCellsBurning) || !readValue(file, &numberOfCellsIgnited) ||
+            !readValue(file, &numberOfCellsBurnedOut) ||
+            !readValue(file, &fire->statistics.maximumFirelineIntensity) ||
+            !readValue(file, &fire->statistics.sumOfFirelineIntensity) ||
+            !readValue(file, &timestepsSinceFrontSort) || timestepsSinceFrontSort < 0 ||
+            !readValue(file, &numberOfBurningCells) || numberOfBurningCells > numberOfCells){
+        return false;
+    }
+    fire->m_weatherEpoch = weatherEpoch;
+    fire->m_timestepsSinceFrontSort = timestepsSinceFrontSort;
+    fire->m_touchedBounds = touchedBounds;
+    fire->numberOfCellsBurning = numberOfCellsBurning;
+    fire->statistics.numberOfCellsIgnited = numberOfCellsIgnited;
+    fire->statistics.numberOfCellsBurnedOut = numberOfCellsBurnedOut;
+    fire->burningCellInformationVector.resize(static_cast<size_t>(numberOfBurningCells));
+    for(auto &burningCell : fire->burningCellInformationVector){
+        std::int32_t xCoord, yCoord, uCoordSource, vCoordSource, cellWeatherEpoch;
+        if(!readValue(file, &xCoord) || !readValue(file, &yCoord) ||
+                !readValue(file, &uCoordSource) || !readValue(file, &vCoordSource) ||
+                !readValue(file, &burningCell.meanFirelineIntensity) ||
+                !readArray(file, &burningCell.burnStatus) || !readArray(file, &burningCell.spreadDirection) ||
+                !readValue(file, &burningCell.rateOfSpread) || !readValue(file, &burningCell.firelineIntensity) ||
+                !readValue(file, &cellWeatherEpoch) || xCoord < 0 || xCoord >= width || yCoord < 0 || yCoord >= height){
+            return false;
+        }
+        burningCell.xCoord = xCoord;
+        burningCell.yCoord = yCoord;
+        burningCell.uCoordSource = uCoordSource;
+        burningCell.vCoordSource = vCoordSource;
+        burningCell.weatherEpoch = cellWeatherEpoch;
+    }
+
+    std::uint8_t simulated;
+    if(!readVector(file, &weatherTimeline->m_hourlyWeather, 1 << 24) || !readValue(file, &simulated) ||
+            (simulated != 0) != (weatherTimeline->m_weatherSimulation != nullptr)){
+        return false;
+    }
+    FireWeather *weatherSimulation = weatherTimeline->m_weatherSimulation;
+    if(weatherSimulation){
+        std::uint8_t windyConditions;
+        std::int32_t windDirection, startingTime;
+        if(!readValue(file, &windyConditions) || !readValue(file, &weatherSimulation->windSpeed) ||
+                !readValue(file, &windDirection) || !readValue(file, &weatherSimulation->relHumidity) ||
+                !readValue(file, &weatherSimulation->temperature) || !readValue(file, &weatherSimulation->Tn) ||
+                !readValue(file, &weatherSimulation->Tx) || !readValue(file, &weatherSimulation->Tp) ||
+                !readValue(file, &startingTime)){
+            return false;
+        }
+        weatherSimulation->windyConditions = windyConditions != 0;
+        weatherSimulation->windDirection = windDirection;
+        weatherSimulation->startingTime = startingTime;
+    }
+    std::uint64_t numberOfWeatherLines;
+    if(!readValue(file, &numberOfWeatherLines) || numberOfWeatherLines > (1 << 24)){
+        return false;
+    }
+    output->weatherData.clear();
+    for(std::uint64_t i = 0; i < numberOfWeatherLines; i++){
+        std::uint32_t length;
+        if(!readValue(file, &length) || length > (1 << 16)){
+            return false;
+        }
+        std::string line(length, ' ');
+        file.read(&line[0], length);
+        output->weatherData.push_back(line);
+    }
+    return static_cast<bool>(file);
+}
+
+}  // namespace wildland_firesim
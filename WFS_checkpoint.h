@@ -0,0 +1,80 @@
+#ifndef WILDLAND_FIRESIM_CHECKPOINT_H
+#define WILDLAND_FIRESIM_CHECKPOINT_H
+
+#include <string>
+#include "fire.h"
+#include "landscape_interface.h"
+#include "WFS_output.h"
+#include "WFS_weathertimeline.h"
+
+namespace wildland_firesim {
+
+/*!
+ * \brief The SimulationProgress struct
+ * position of a fire in progress: the timestep to be simulated next, the duration of the fire and
+ * the current weather epoch.
+ */
+struct SimulationProgress {
+    int run = 0;
+    int timestep = 1;
+    float durationOfBurn = 0.f;
+    int weatherEpoch = 0;
+    int timestepLength = 0; //only checked when the fire is restored
+};
+
+/*!
+ * \brief The Checkpoint class
+ * writes the state of a fire in progress into a binary file and restores it, so a fire continues
+ * after a restart exactly as it would have without. A checkpoint holds the progress, the cell
+ * states (run-length encoded), the burning cells, the fire weather and the state of the random
+ * stream of the fire. The vegetation is not stored: it is not changed by the fire and is restored
+ * by loading or generating the landscape of the run again.
+ */
+class Checkpoint
+{
+public:
+    /*!
+     * \brief write
+     * writes the checkpoint into a temporary file which then replaces fileName, so an interrupted
+     * write leaves the previous checkpoint intact.
+     * \param fileName
+     * \param progress
+     * \param landscape
+     * \param fire
+     * \param weatherTimeline
+     * \param output stored fire weather of the run
+     * \return false if the file could not be written
+     */
+    static bool write(const std::string &fileName, const SimulationProgress &progress,
+                      LandscapeInterface *landscape, const Fire &fire,
+                      const WeatherTimeline &weatherTimeline, const Output &output);
+
+    /*!
+     * \brief readProgress
+     * reads only the progress, e.g. to find the run to resume.
+     * \param fileName
+     * \param progress
+     * \return false if the file is not a valid checkpoint
+     */
+    static bool readProgress(const std::string &fileName, SimulationProgress *progress);
+
+    /*!
+     * \brief read
+     * restores the state of a fire. The landscape has to be the unburned landscape of the run and
+     * the weather timeline has to be set up as for the run.
+     * \param fileName
+     * \param progress
+     * \param landscape
+     * \param fire
+     * \param weatherTimeline
+     * \param output
+     * \return false if the file is not a valid checkpoint or does not fit the landscape
+     */
+    static bool read(const std::string &fileName, SimulationProgress *progress,
+                     LandscapeInterface *landscape, Fire *fire,
+                     WeatherTimeline *weatherTimeline, Output *output);
+};
+
+}  // namespace wildland_firesim
+
+#endif // WILDLAND_FIRESIM_CHECKPOINT_H
@@ -0,0 +1,161 @@
+#include "WFS_components.h"
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include "WFS_tracing.h"
+
+namespace wildland_firesim {
+namespace {
+
+//rows labelled by one worker at a time
+constexpr int StripHeight = 64;
+
+int
+findRoot(std::vector<int> &parents, int cell)
+{
+    while(parents[static_cast<size_t>(cell)] != cell){
+        //path halving
+        int &parent = parents[static_cast<size_t>(cell)];
+        parent = parents[static_cast<size_t>(parent)];
+        cell = parent;
+    }
+    return cell;
+}
+
+//the smaller cell index becomes the root, so a strip only links to cells of its own rows
+void
+unite(std::vector<int> &parents, int a, int b)
+{
+    a = findRoot(parents, a);
+    b = findRoot(parents, b);
+    if(a < b){
+        parents[static_cast<size_t>(b)] = a;
+    } else if(b < a){
+        parents[static_cast<size_t>(a)] = b;
+    }
+}
+
+}
+
+constexpr int FlammableComponents::NoComponent;
+
+FlammableComponents::FlammableComponents()
+    : m_width(0), m_height(0), m_components(), m_sizes()
+{
+
+}
+
+void
+FlammableComponents::label(const LandscapeInterface &landscape, int numberOfThreads)
+{
+    WILDLAND_TRACE_SPAN("labelComponents");
+    m_width = landscape.getWidth();
+    m_height = landscape.getHeight();
+    int width = m_width;
+    std::vector<int> parents(static_cast<size_t>(m_width) * m_height);
+    auto isFlammable = [&](int x, int y) {
+        return landscape.getCellInformation(x, y)->type == VegetationType::Grass;
+    };
+    //neighbours labelled before a cell: left, lower left, below and lower right
+    auto uniteWithPreviousNeighbours = [&](int x, int y, bool left, bool below) {
+        int cell = y * width + x;
+        if(left && x > 0 && isFlammable(x - 1, y)){
+            unite(parents, cell, cell - 1);
+        }
+        if(below){
+            for(int dx = -1; dx <= 1; dx++){
+                if(x + dx >= 0 && x + dx < width && isFlammable(x + dx, y - 1)){
+                    unite(parents, cell, cell - width + dx);
+                }
+            }
+        }
+    };
+
+    int numberOfStrips = (m_height + StripHeight - 1) / StripHeight;
+    std::atomic<int> nextStrip{0};
+    auto worker = [&]() {
+        for(int strip = nextStrip++; strip < numberOfStrips; strip = nextStrip++){
+            int y0 = strip * StripHeight;
+            int y1 = std::min(y0 + StripHeight, m_height);
+            for(int y = y0; y < y1; y++)
+                for(int x = 0; x < m_width; x++){
+                    int cell = y * width + x;
+                    if(!isFlammable(x, y)){
+                        parents[static_cast<size_t>(cell)] = NoComponent;
+                        continue;
+                    }
+                    parents[static_cast<size_t>(cell)] = cell;
+                    uniteWithPreviousNeighbours(x, y, true, y > y0);
+                }
+        }
+    };
+    numberOfThreads = std::max(1, std::min(numberOfThreads, numberOfStrips));
+    std::vector<std::thread> threads;
+    for(int i = 1; i < numberOfThreads; i++){
+        threads.emplace_back(worker);
+    }
+    worker();
+    for(auto &thread : threads){
+        thread.join();
+    }
+
+    //join the strips along their borders
+    for(int y = StripHeight; y < m_height; y += StripHeight)
+        for(int x = 0; x < m_width; x++){
+            if(isFlammable(x, y)){
+                uniteWithPreviousNeighbours(x, y, false, true);
+            }
+        }
+
+    //number the components in row order and collect their sizes
+    m_components.assign(parents.size(), NoComponent);
+    m_sizes.clear();
+    for(int y = 0; y < m_height; y++)
+        for(int x = 0; x < m_width; x++){
+            int cell = y * width + x;
+            if(parents[static_cast<size_t>(cell)] == NoComponent) continue;
+            int root = findRoot(parents, cell);
+            int component = root == cell ? static_cast<int>(m_sizes.size()) : m_components[static_cast<size_t>(root)];
+            if(root == cell){
+                m_sizes.push_back(0);
+            }
+            m_components[static_cast<size_t>(cell)] = component;
+            m_sizes[static_cast<size_t>(component)]++;
+        }
+}
+
+int
+FlammableComponents::getNumberOfComponents() const noexcept
+{
+    return static_cast<int>(m_sizes.size());
+}
+
+int
+FlammableComponents::getComponent(int x, int y) const
+{
+    if(x < 0 || x >= m_width || y < 0 || y >= m_height){
+        return NoComponent;
+    }
+    return m_components[static_cast<size_t>(y) * m_width + x];
+}
+
+int
+FlammableComponents::getComponentAtVertex(int u, int v) const
+{
+    int cellsBorderingVertex[4][2] = {{u,v},{u,v-1},{u-1,v-1},{u-1,v}};
+    for(const auto &cell : cellsBorderingVertex){
+        int component = getComponent(cell[0], cell[1]);
+        if(component != NoComponent){
+            return component;
+        }
+    }
+    return NoComponent;
+}
+
+int
+FlammableComponents::getSize(int component) const
+{
+    return m_sizes[static_cast<size_t>(component)];
+}
+
+}  // namespace wildland_firesim
@@ -0,0 +1,71 @@
+#ifndef WILDLAND_FIRESIM_COMPONENTS_H
+#define WILDLAND_FIRESIM_COMPONENTS_H
+
+#include <vector>
+#include "landscape_interface.h"
+
+namespace wildland_firesim {
+
+/*!
+ * \brief The FlammableComponents class
+ * labels the connected components of grass cells of a landscape. A fire reaches the four cells
+ * sharing a vertex from each of them, so cells touching at a corner are connected as well
+ * (8-connectivity), and a fire never leaves the components of the cells it was ignited in. The
+ * four cells bordering a vertex touch each other, so a vertex borders at most one component. The
+ * components screen the vertices of an IgnitionSampler; the cells a fire reached are bounded by
+ * Fire::getTouchedBounds.
+ *
+ * Components are found with union-find: strips of rows are labelled in parallel, then joined
+ * along the strip borders. Component numbers follow the first cell of each component in row order
+ * and do not depend on the number of threads.
+ */
+class FlammableComponents
+{
+public:
+    FlammableComponents();
+
+    /*!
+     * \brief label
+     * finds the components of the grass cells of the landscape.
+     * \param landscape
+     * \param numberOfThreads
+     */
+    void label(const LandscapeInterface &landscape, int numberOfThreads);
+
+    int getNumberOfComponents() const noexcept;
+
+    /*!
+     * \brief getComponent
+     * \param x
+     * \param y
+     * \return component of the cell, NoComponent if it is not flammable
+     */
+    int getComponent(int x, int y) const;
+
+    /*!
+     * \brief getComponentAtVertex
+     * \param u
+     * \param v
+     * \return component of the grass cells bordering the vertex, NoComponent if there are none
+     */
+    int getComponentAtVertex(int u, int v) const;
+
+    /*!
+     * \brief getSize
+     * \param component
+     * \return number of cells of the component
+     */
+    int getSize(int component) const;
+
+    static constexpr int NoComponent = -1;
+
+private:
+    int m_width;
+    int m_height;
+    std::vector<int> m_components;
+    std::vector<int> m_sizes;
+};
+
+}  // namespace wildland_firesim
+
+#endif // WILDLAND_FIRESIM_COMPONENTS_H
@@ -0,0 +1,146 @@
+#include "WFS_ensemble.h"
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <limits>
+#include "utility.h"
+#include "WFS_tracing.h"
+
+namespace wildland_firesim {
+namespace {
+
+//quantile of the standard normal distribution for 95% confidence intervals
+constexpr double ConfidenceQuantile = 1.959964;
+
+double
+wilsonHalfWidth(long long burnCount, int numberOfRuns)
+{
+    double n = numberOfRuns;
+    double p = burnCount / n;
+    double z2 = ConfidenceQuantile * ConfidenceQuantile;
+    return ConfidenceQuantile / (1.0 + z2 / n) * std::sqrt(p * (1.0 - p) / n + z2 / (4.0 * n * n));
+}
+
+}
+
+EnsembleStatistics::EnsembleStatistics()
+    : m_width(0), m_height(0), m_numberOfRuns(0), m_burnCount(), m_weightedBurnCount(),
+      m_sumOfWeights(0.0), m_cellsWithBurnCount(),
+      m_meanBurnedArea(0.0), m_squaredDeviationsOfBurnedArea(0.0)
+{
+
+}
+
+void
+EnsembleStatistics::addRun(const LandscapeInterface &landscape, double weight)
+{
+    addRun(landscape, weight, CellBounds::all(landscape));
+}
+
+void
+EnsembleStatistics::addRun(const LandscapeInterface &landscape, double weight, const CellBounds &bounds)
+{
+    if(m_numberOfRuns == 0){
+        m_width = landscape.getWidth();
+        m_height = landscape.getHeight();
+        m_burnCount.assign(static_cast<size_t>(m_width) * m_height, 0);
+        m_weightedBurnCount.assign(m_burnCount.size(), 0.0);
+        m_cellsWithBurnCount.assign(1, static_cast<long long>(m_burnCount.size()));
+    }
+    WILDLAND_ASSERT(landscape.getWidth() == m_width && landscape.getHeight() == m_height,
+                    "all runs of an ensemble need landscapes of the same size");
+
+    m_cellsWithBurnCount.push_back(0);
+    long long burnedCells = 0;
+    for(int y = bounds.minY; y <= bounds.maxY; y++){
+        for(int x = bounds.minX; x <= bounds.maxX; x++){
+            if(landscape.getCellInformation(x, y)->getState(landscape.getStateEpoch()) != CellState::Unburned){
+                size_t index = static_cast<size_t>(y) * m_width + x;
+                int &count = m_burnCount[index];
+                m_weightedBurnCount[index] += weight;
+                m_cellsWithBurnCount[static_cast<size_t>(count)]--;
+                count++;
+                m_cellsWithBurnCount[static_cast<size_t>(count)]++;
+                burnedCells++;
+            }
+        }
+    }
+
+    double cellArea = static_cast<double>(landscape.getCellSize()) * landscape.getCellSize();
+    double burnedArea = weight * burnedCells * cellArea / 10000.0;
+    m_numberOfRuns++;
+    m_sumOfWeights += weight;
+    double deviation = burnedArea - m_meanBurnedArea;
+    m_meanBurnedArea += deviation / m_numberOfRuns;
+    m_squaredDeviationsOfBurnedArea += deviation * (burnedArea - m_meanBurnedArea);
+}
+
+int
+EnsembleStatistics::getNumberOfRuns() const noexcept
+{
+    return m_numberOfRuns;
+}
+
+float
+EnsembleStatistics::getMaximumCellHalfWidth() const
+{
+    if(m_numberOfRuns == 0){
+        return 1.f;
+    }
+    double maximum = 0.0;
+    for(size_t count = 0; count < m_cellsWithBurnCount.size(); count++){
+        if(m_cellsWithBurnCount[count] > 0){
+            maximum = std::max(maximum, wilsonHalfWidth(static_cast<long long>(count), m_numberOfRuns));
+        }
+    }
+    return static_cast<float>(maximum * m_sumOfWeights / m_numberOfRuns);
+}
+
+float
+EnsembleStatistics::getMeanBurnedArea() const noexcept
+{
+    return static_cast<float>(m_meanBurnedArea);
+}
+
+float
+EnsembleStatistics::getBurnedAreaHalfWidth() const
+{
+    if(m_numberOfRuns < 2){
+        return std::numeric_limits<float>::infinity();
+    }
+    double variance = m_squaredDeviationsOfBurnedArea / (m_numberOfRuns - 1);
+    return static_cast<float>(ConfidenceQuantile * std::sqrt(variance / m_numberOfRuns));
+}
+
+bool
+EnsembleStatistics::hasConverged(float precision) const
+{
+    return m_numberOfRuns >= MinimumNumberOfRuns &&
+            getMaximumCellHalfWidth() <= precision &&
+            getBurnedAreaHalfWidth() <= precision * getMeanBurnedArea();
+}
+
+void
+EnsembleStatistics::writeBurnProbabilityToASCII(const std::string &fileName) const
+{
+    WILDLAND_TRACE_SPAN("writeBurnProbability");
+    std::ofstream probabilityFile;
+    probabilityFile.open(fileName);
+
+    probabilityFile << "NCOLS " << m_width << std::endl;
+    probabilityFile << "NROWS " << m_height << std::endl;
+    probabilityFile << "XLLCORNER " << "0"  << std::endl;
+    probabilityFile << "YLLCORNER " << "0"  << std::endl;
+    probabilityFile << "CELLSIZE " << "1" << std::endl;
+    probabilityFile << "NODATA_VALUE " << "-9999" << std::endl;
+
+    for (int y = (m_height-1); y >= 0; y--)
+        for (int x = 0; x < m_width; x++) {
+            probabilityFile << static_cast<float>(m_weightedBurnCount[static_cast<size_t>(y) * m_width + x] /
+                                                  std::max(m_numberOfRuns, 1)) << " ";
+        }
+    probabilityFile << "\n";
+    probabilityFile.close();
+}
+
+}  // namespace wildland_firesim
@@ -0,0 +1,99 @@
+#ifndef WILDLAND_FIRESIM_ENSEMBLE_H
+#define WILDLAND_FIRESIM_ENSEMBLE_H
+
+#include <string>
+#include <vector>
+#include "landscape_interface.h"
+#include "WFS_components.h"
+
+namespace wildland_firesim {
+
+/*!
+ * \brief The EnsembleStatistics class
+ * accumulates the burn probability of each cell and the burned area over the runs of an ensemble,
+ * so the ensemble can stop once the estimates are precise enough. Precision is the half-width of the
+ * 95% confidence interval: the Wilson score interval for the burn probabilities and the normal
+ * interval of the mean for the burned area. Cells still burning at the end of a run count as burned.
+ *
+ * Runs may carry importance weights, e.g. those of an IgnitionSampler; the estimates are then the
+ * weighted means over the runs. The half-widths of the burn probabilities are those of the
+ * unweighted burn fractions scaled by the mean weight, which is exact if all runs have the same
+ * weight.
+ */
+class EnsembleStatistics
+{
+public:
+    EnsembleStatistics();
+
+    /*!
+     * \brief addRun
+     * adds the burned cells of a finished run.
+     * \param landscape
+     * \param weight importance weight of the run
+     */
+    void addRun(const LandscapeInterface &landscape, double weight = 1.0);
+
+    /*!
+     * \brief addRun
+     * adds the burned cells of a finished run whose fire did not burn outside of the bounds.
+     * \param landscape
+     * \param weight importance weight of the run
+     * \param bounds e.g. Fire::getTouchedBounds()
+     */
+    void addRun(const LandscapeInterface &landscape, double weight, const CellBounds &bounds);
+
+    int getNumberOfRuns() const noexcept;
+
+    /*!
+     * \brief getMaximumCellHalfWidth
+     * \return largest half-width of the confidence intervals of the burn probabilities of all cells
+     */
+    float getMaximumCellHalfWidth() const;
+
+    /*!
+     * \brief getMeanBurnedArea
+     * \return in ha
+     */
+    float getMeanBurnedArea() const noexcept;
+
+    /*!
+     * \brief getBurnedAreaHalfWidth
+     * \return half-width of the confidence interval of the mean burned area in ha
+     */
+    float getBurnedAreaHalfWidth() const;
+
+    /*!
+     * \brief hasConverged
+     * is true after at least MinimumNumberOfRuns runs if the burn probability of every cell is known
+     * within +- precision and the mean burned area within +- precision relative to it.
+     * \param precision e.g. 0.05
+     * \return
+     */
+    bool hasConverged(float precision) const;
+
+    /*!
+     * \brief writeBurnProbabilityToASCII
+     * writes the (weighted) fraction of runs in which each cell burned into an ascii-grid.
+     * \param fileName
+     */
+    void writeBurnProbabilityToASCII(const std::string &fileName) const;
+
+    static constexpr int MinimumNumberOfRuns = 10;
+
+private:
+    int m_width;
+    int m_height;
+    int m_numberOfRuns;
+    std::vector<int> m_burnCount;
+    std::vector<double> m_weightedBurnCount;
+    double m_sumOfWeights;
+    //number of cells per burn count, the half-widths only depend on the count
+    std::vector<long long> m_cellsWithBurnCount;
+    //running mean and sum of squared deviations of the burned area (Welford)
+    double m_meanBurnedArea;
+    double m_squaredDeviationsOfBurnedArea;
+};
+
+}  // namespace wildland_firesim
+
+#endif // WILDLAND_FIRESIM_ENSEMBLE_H
@@ -1,4 +1,5 @@
 #include "WFS_fireweather.h"
+#include "WFS_probes.h"
 
 namespace wildland_firesim {
 
@@ -84,6 +85,24 @@ FireWeather::importMeteorologicalParameter(const std::string fileName)
         m_sunriseTime[month] = utility::asFloat(parameters[18][month].c_str());
         m_sunsetTime[month] = utility::asFloat(parameters[19][month].c_str());;
     }
+
+    //wind directions were drawn by testing each direction against its probability in turn, keeping
+    //the last direction that passed and repeating until any but the first direction passed. The
+    //alias tables reproduce the resulting distribution without the rejection loop.
+    for(size_t month = 0; month < NumberOfMonths; ++month) {
+        std::vector<float> weights(WindDirectionsCount, 0.f);
+        float probabilityNoLaterDirection = 1.f;
+        for(int k = WindDirectionsCount - 1; k > 0; --k) {
+            float p = std::min(std::max(m_windDirectionProbability[month][k], 0.f), 1.f);
+            weights[static_cast<size_t>(k)] = p * probabilityNoLaterDirection;
+            probabilityNoLaterDirection *= 1.f - p;
+        }
+        if (!m_windDirectionDistribution[month].build(weights)) {
+            std::cerr << "invalid configuration: wind direction probabilities of month " << month + 1
+                      << " must not all be zero\n";
+            std::exit(1);
+        }
+    }
 }
 
 void
@@ -91,10 +110,50 @@ FireWeather::setStartingTime(int startOfFire){
     startingTime = startOfFire;
 }
 
+FireWeatherVariables
+FireWeather::getFireWeatherVariables() const
+{
+    FireWeatherVariables weather;
+    weather.windSpeed = windSpeed;
+    weather.windDirection = windDirection;
+    weather.relHumidity = relHumidity;
+    weather.temperature = temperature;
+    return weather;
+}
+
+std::uint64_t
+FireWeather::getParameterHash() const
+{
+    std::uint64_t hash = 14695981039346656037ull;
+    auto add = [&hash](const void *data, size_t size) {
+        const unsigned char *bytes = static_cast<const unsigned char *>(data);
+        for(size_t i = 0; i < size; i++){
+            hash ^= bytes[i];
+            hash *= 1099511628211ull;
+        }
+    };
+    add(m_minimumDailyTemperatureParameter, sizeof(m_minimumDailyTemperatureParameter));
+    add(m_maximumDailyTemperatureParameter, sizeof(m_maximumDailyTemperatureParameter));
+    add(m_relativeHumidityParameter, sizeof(m_relativeHumidityParameter));
+    add(m_windSpeedParameter, sizeof(m_windSpeedParameter));
+    add(m_windConditionChange, sizeof(m_windConditionChange));
+    add(m_windDirectionProbability, sizeof(m_windDirectionProbability));
+    add(m_sunriseTime, sizeof(m_sunriseTime));
+    add(m_sunsetTime, sizeof(m_sunsetTime));
+    return hash;
+}
+
 void
 FireWeather::calculateFireWeather(int month,int durationOfBurn)
+{
+    calculateFireWeather(month, durationOfBurn, utility::globalRandomStream());
+}
+
+void
+FireWeather::calculateFireWeather(int month, int durationOfBurn, utility::RandomStream &random)
 {
     //WILDLAND_ASSERT(m_initialized, "landscape is not initialized");
+    WILDLAND_PROBE2(weather__begin, month, durationOfBurn);
 
     //temperature calculations
     //get time (t)
@@ -111,11 +170,11 @@ FireWeather::calculateFireWeather(int month,int durationOfBurn)
     // chose minimal temperature, maximal temperature and minimum temperature of following day
     // from distribution. at start of the fire and every 24 h
     if((t == 0) || durationOfBurn == 0){
-        Tn = utility::normal_random(m_minimumDailyTemperatureParameter[month].param1,
+        Tn = random.normal_random(m_minimumDailyTemperatureParameter[month].param1,
                                     m_minimumDailyTemperatureParameter[month].param2);
-        Tx = utility::normal_random(m_maximumDailyTemperatureParameter[month].param1,
+        Tx = random.normal_random(m_maximumDailyTemperatureParameter[month].param1,
                                     m_maximumDailyTemperatureParameter[month].param2);
-        Tp = utility::normal_random(m_minimumDailyTemperatureParameter[month].param1,
+        Tp = random.normal_random(m_minimumDailyTemperatureParameter[month].param1,
                                     m_minimumDailyTemperatureParameter[month].param2);
     }
     //temperature at sunset, c=0.39, empirical estimate from californian weather data
@@ -137,52 +196,41 @@ FireWeather::calculateFireWeather(int month,int durationOfBurn)
     }
 
     //derive relative humidity from distribution
-    relHumidity = utility::random(m_relativeHumidityParameter[month].param1,
+    relHumidity = random.random(m_relativeHumidityParameter[month].param1,
                                   m_relativeHumidityParameter[month].param2);
 
     //determine wind conditions
     windDirection = 0;
     // if it is not calm and staying calm, or wind does not cease, let there be wind.
     if(windyConditions == false){
-        if(utility::random()<m_windConditionChange[month].stayCalm){
+        if(random.random()<m_windConditionChange[month].stayCalm){
             windyConditions = false;
             windSpeed = 0.0;
         } else
         {
             windyConditions = true;
             //determine wind direction
-            while(windDirection == 0){
-                for(int k = 0; k<WindDirectionsCount ;++k) {
-                    if (utility::random() < m_windDirectionProbability[month][k]) {
-                        windDirection = k;
-                    }
-                }
-            }
+            windDirection = m_windDirectionDistribution[month].sample(random);
             //derive wind speed from distribution
-            windSpeed = utility::weibull_random(m_windSpeedParameter[month].param1,
+            windSpeed = random.weibull_random(m_windSpeedParameter[month].param1,
                                                 m_windSpeedParameter[month].param2);
         }
     } else {
-        if(utility::random()<m_windConditionChange[month].windyToCalm){
+        if(random.random()<m_windConditionChange[month].windyToCalm){
             windyConditions = false;
             windSpeed = 0.0;
         }
         else
         {
             windyConditions = true;
-            //determine wind direction --> undefined behavior if wd is not set.
-            while(windDirection == 0){
-                for(int k = 0; k<WindDirectionsCount ;++k) {
-                    if (utility::random() < m_windDirectionProbability[month][k]) {
-                        windDirection = k;
-                    }
-                }
-            }
+            //determine wind direction
+            windDirection = m_windDirectionDistribution[month].sample(random);
             //derive wind speed from distribution
-            windSpeed = utility::weibull_random(m_windSpeedParameter[month].param1,
+            windSpeed = random.weibull_random(m_windSpeedParameter[month].param1,
                                                 m_windSpeedParameter[month].param2);
         }
     }
+    WILDLAND_PROBE3(weather__end, month, durationOfBurn, windDirection);
 }
 
 }//namespace wildland_firesim
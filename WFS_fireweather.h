@@ -6,6 +6,7 @@
 #include <vector>
 #include <sstream>
 #include <cmath>
+#include <cstdint>
 #include "csvreader.h"
 #include "utility.h"
 #include "globals.h"
@@ -38,6 +39,8 @@ constexpr int WindDirectionsCount = 8;
  */
 class FireWeather
 {
+    friend class Checkpoint;
+
 public:
     FireWeather();
     /*!
@@ -67,6 +70,15 @@ public:
      */
     void calculateFireWeather(int month, int durationOfBurn);
 
+    /*!
+     * \brief calculateFireWeather
+     * simulates hourly fire weather drawing from the given random stream instead of the global one.
+     * \param month
+     * \param durationOfBurn
+     * \param random
+     */
+    void calculateFireWeather(int month, int durationOfBurn, utility::RandomStream &random);
+
     /*!
      * \brief setStartingTime
      * sets time to start a fire.
@@ -74,6 +86,21 @@ public:
      */
     void setStartingTime(int startOfFire);
 
+    /*!
+     * \brief getFireWeatherVariables
+     * returns the current meteorological variables in the form used by the fire spread kernel.
+     * \return
+     */
+    FireWeatherVariables getFireWeatherVariables() const;
+
+    /*!
+     * \brief getParameterHash
+     * identifies the imported meteorological parameters, e.g. to check that precomputed weather was
+     * simulated with them.
+     * \return FNV-1a hash of the parameters of all months
+     */
+    std::uint64_t getParameterHash() const;
+
     //Meteorological Variables
     bool windyConditions;
     float windSpeed;
@@ -88,6 +115,7 @@ private:
     distrParameter<float> m_windSpeedParameter[NumberOfMonths];
     WindCondition m_windConditionChange[NumberOfMonths];
     float m_windDirectionProbability[NumberOfMonths][WindDirectionsCount];
+    utility::AliasTable m_windDirectionDistribution[NumberOfMonths];
     float m_sunriseTime [NumberOfMonths];
     float m_sunsetTime [NumberOfMonths];
     // Tn: min temperature, Tx: max temperature, Tp: min temperature of following day
@@ -0,0 +1,111 @@
+#include "WFS_fork.h"
+#include "WFS_tracing.h"
+#include <algorithm>
+#include <fstream>
+#include <memory>
+
+namespace wildland_firesim {
+
+WeatherFork::WeatherFork() : m_summaries()
+{
+
+}
+
+void
+WeatherFork::runBranches(const WFS_Landscape &landscape, const Simulation &settings,
+                         const WeatherTrajectoryBank &bank, int decisionHour, int numberOfBranches,
+                         unsigned int seed, TaskScheduler &scheduler)
+{
+    m_summaries.assign(static_cast<size_t>(numberOfBranches), BranchSummary());
+    float cellArea = static_cast<float>(landscape.getCellSize()) * landscape.getCellSize();
+
+    //common part of the fire up to the decision hour
+    TiledLandscape commonLandscape{landscape};
+    utility::RandomStream commonRandom{seed};
+    Output commonOutput;
+    SimulationSnapshot snapshot = [&]() {
+        WILDLAND_TRACE_SPAN("commonFire");
+        Simulation simulation = settings;
+        simulation.fire.setRandomStream(&commonRandom);
+        simulation.timestepCallback = [decisionHour](int, float durationOfBurn) {
+            return durationOfBurn < decisionHour;
+        };
+        WeatherTimeline weatherTimeline;
+        weatherTimeline.setWeatherTrajectory(bank, settings.whichMonth, 0);
+        simulation.runSimulation(&commonLandscape, &weatherTimeline, &commonOutput);
+        return simulation.takeSnapshot(&commonLandscape, commonOutput);
+    }();
+
+    //simulation, weather and output of each thread
+    struct Workspace {
+        Simulation simulation;
+        WeatherTimeline weatherTimeline;
+        Output output;
+    };
+    std::vector<std::unique_ptr<Workspace>> workspaces(static_cast<size_t>(scheduler.getNumberOfThreads()));
+
+    scheduler.parallelFor(0, static_cast<size_t>(numberOfBranches), 1, [&](size_t begin, size_t end) {
+        std::unique_ptr<Workspace> &workspace = workspaces[static_cast<size_t>(scheduler.getThreadIndex())];
+        if(!workspace){
+            workspace.reset(new Workspace{settings, WeatherTimeline(), Output()});
+        }
+        Simulation &simulation = workspace->simulation;
+        WeatherTimeline &weatherTimeline = workspace->weatherTimeline;
+        Output &output = workspace->output;
+        for(int i = static_cast<int>(begin); i < static_cast<int>(end); i++){
+            WILDLAND_TRACE_SPAN("branch");
+            int trajectory = i % bank.getNumberOfTrajectories();
+            utility::RandomStream random = commonRandom;
+            simulation.fire.setRandomStream(&random);
+            weatherTimeline.setWeatherTrajectory(bank, settings.whichMonth, trajectory);
+            TiledLandscape branchLandscape = snapshot.landscape.fork();
+            simulation.continueFromSnapshot(snapshot, &branchLandscape, &weatherTimeline, &output);
+
+            output.writeBurnMapToASCII(branchLandscape, output.setfileName("burn_map", ".asc", i));
+            output.writeBurnDataToCSV(branchLandscape, simulation.fire, output.setfileName("burndata", ".csv", i));
+            if(simulation.simulateFireWeather){
+                output.writeFireWeatherDataToCSV(output.weatherData, output.setfileName("weatherdata", ".csv", i));
+            }
+
+            const FireStatistics &statistics = simulation.fire.statistics;
+            BranchSummary &summary = m_summaries[static_cast<size_t>(i)];
+            summary.trajectory = trajectory;
+            //cells still burning when the maximal duration is reached count as burned
+            summary.burnedCells = statistics.numberOfCellsBurnedOut + simulation.fire.numberOfCellsBurning;
+            summary.burnedArea = summary.burnedCells * cellArea / 10000.f;
+            summary.duration = simulation.durationOfFire;
+            summary.meanFirelineIntensity = statistics.numberOfCellsBurnedOut > 0 ?
+                        static_cast<float>(statistics.sumOfFirelineIntensity / statistics.numberOfCellsBurnedOut) : 0.f;
+            summary.maximumFirelineIntensity = statistics.maximumFirelineIntensity;
+            summary.copiedTiles = branchLandscape.getNumberOfOwnedTiles();
+        }
+    });
+}
+
+void
+WeatherFork::writeSummaryToCSV(const std::string &fileName) const
+{
+    std::ofstream summaryFile;
+    summaryFile.open(fileName);
+    //header
+    summaryFile << "branch,trajectory,burnedCells,burnedArea,duration,meanIntensity,maxIntensity,copiedTiles" << "\n";
+    //data
+    for(size_t i = 0; i < m_summaries.size(); i++){
+        const BranchSummary &summary = m_summaries[i];
+        summaryFile << i << "," << summary.trajectory << ",";
+        summaryFile << summary.burnedCells << "," << summary.burnedArea << ",";
+        summaryFile << summary.duration << ",";
+        summaryFile << summary.meanFirelineIntensity << "," << summary.maximumFirelineIntensity << ",";
+        summaryFile << summary.copiedTiles;
+        summaryFile << "\n";
+    }
+    summaryFile.close();
+}
+
+const std::vector<BranchSummary> &
+WeatherFork::getSummaries() const noexcept
+{
+    return m_summaries;
+}
+
+}  // namespace wildland_firesim
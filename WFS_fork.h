@@ -0,0 +1,74 @@
+#ifndef WILDLAND_FIRESIM_FORK_H
+#define WILDLAND_FIRESIM_FORK_H
+
+#include <string>
+#include <vector>
+#include "fire.h"
+#include "simulation.h"
+#include "WFS_landscape.h"
+#include "WFS_weatherbank.h"
+#include "WFS_scheduler.h"
+
+namespace wildland_firesim {
+
+/*!
+ * \brief The BranchSummary struct
+ * holds the result of one branch of a fire.
+ */
+struct BranchSummary {
+    int trajectory;
+    int burnedCells;
+    float burnedArea;
+    float duration;
+    float meanFirelineIntensity;
+    float maximumFirelineIntensity;
+    int copiedTiles;
+};
+
+/*!
+ * \brief The WeatherFork class
+ * burns a landscape until a decision hour and then branches the fire into alternative weather
+ * futures. The common part of the fire is simulated once; the branches continue in parallel from a
+ * snapshot and share the landscape tiles their fires do not reach. All branches continue the random
+ * stream of the common part (common random numbers), so they differ only by their weather, and the
+ * branch under the weather of the common part burns exactly like an unbranched fire.
+ */
+class WeatherFork
+{
+public:
+    WeatherFork();
+
+    /*!
+     * \brief runBranches
+     * burns the landscape under the first trajectory of the bank until the decision hour, then
+     * continues the fire under each trajectory of the bank. Burn map, burn data and fire weather of
+     * each branch are written like those of a run.
+     * \param landscape unburned landscape
+     * \param settings simulation parameters (timestep length, maximal duration, ignition, month)
+     * \param bank weather trajectories, branch i uses trajectory i modulo their number
+     * \param decisionHour hours after ignition
+     * \param numberOfBranches
+     * \param seed
+     * \param scheduler runs the branches as tasks
+     */
+    void runBranches(const WFS_Landscape &landscape, const Simulation &settings,
+                     const WeatherTrajectoryBank &bank, int decisionHour, int numberOfBranches,
+                     unsigned int seed, TaskScheduler &scheduler);
+
+    /*!
+     * \brief writeSummaryToCSV
+     * writes one summary row per branch. Burned area is given in ha, duration in h and intensities
+     * in kJ/s/m.
+     * \param fileName
+     */
+    void writeSummaryToCSV(const std::string &fileName) const;
+
+    const std::vector<BranchSummary> &getSummaries() const noexcept;
+
+private:
+    std::vector<BranchSummary> m_summaries;
+};
+
+}  // namespace wildland_firesim
+
+#endif // WILDLAND_FIRESIM_FORK_H
@@ -0,0 +1,294 @@
+#include "WFS_ignition.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include "csvreader.h"
+#include "fire.h"
+#include "utility.h"
+
+namespace wildland_firesim {
+namespace {
+
+std::string
+trimmed(const std::string &value)
+{
+    const char *whitespace = " \t\r\n";
+    auto start = value.find_first_not_of(whitespace);
+    if(start == std::string::npos){
+        return std::string();
+    }
+    return value.substr(start, value.find_last_not_of(whitespace) - start + 1);
+}
+
+//position of (x, y) along the Hilbert curve through a grid of size x size, size a power of two
+std::uint64_t
+hilbertIndex(std::uint32_t size, std::uint32_t x, std::uint32_t y)
+{
+    std::uint64_t index = 0;
+    for(std::uint32_t s = size / 2; s > 0; s /= 2){
+        std::uint32_t rx = (x & s) > 0 ? 1 : 0;
+        std::uint32_t ry = (y & s) > 0 ? 1 : 0;
+        index += static_cast<std::uint64_t>(s) * s * ((3 * rx) ^ ry);
+        //rotate the quadrant
+        if(ry == 0){
+            if(rx == 1){
+                x = size - 1 - x;
+                y = size - 1 - y;
+            }
+            std::swap(x, y);
+        }
+    }
+    return index;
+}
+
+//same requirements as Fire::initiateWildFire except for the ignition probability
+bool
+canIgniteCell(const LandscapeInterface &landscape, int x, int y)
+{
+    if(x < 0 || x >= landscape.getWidth() || y < 0 || y >= landscape.getHeight()) return false;
+    const Cell *cell = landscape.getCellInformation(x, y);
+    return cell->type == VegetationType::Grass &&
+            cell->deadBiomass + cell->liveBiomass >= MinimumIgnitionFuelLoad;
+}
+
+}
+
+IgnitionPattern::IgnitionPattern() : m_vertices(), m_addedVertices()
+{
+
+}
+
+void
+IgnitionPattern::addPoint(int u, int v)
+{
+    std::uint64_t key = static_cast<std::uint64_t>(static_cast<std::uint32_t>(u)) << 32 |
+            static_cast<std::uint32_t>(v);
+    if(m_addedVertices.insert(key).second){
+        m_vertices.push_back(IgnitionVertex{u, v});
+    }
+}
+
+void
+IgnitionPattern::addPolyline(const std::vector<IgnitionVertex> &points)
+{
+    if(points.size() == 1){
+        addPoint(points[0].u, points[0].v);
+    }
+    for(size_t i = 1; i < points.size(); i++){
+        //Bresenham's line algorithm, a diagonal step moves to the vertex across the cell
+        int u = points[i - 1].u;
+        int v = points[i - 1].v;
+        int du = std::abs(points[i].u - u);
+        int dv = -std::abs(points[i].v - v);
+        int stepU = u < points[i].u ? 1 : -1;
+        int stepV = v < points[i].v ? 1 : -1;
+        int error = du + dv;
+        while(true){
+            addPoint(u, v);
+            if(u == points[i].u && v == points[i].v) break;
+            int doubledError = 2 * error;
+            if(doubledError >= dv){
+                error += dv;
+                u += stepU;
+            }
+            if(doubledError <= du){
+                error += du;
+                v += stepV;
+            }
+        }
+    }
+}
+
+void
+IgnitionPattern::addMask(const RasterView<std::uint8_t> &mask, int width, int height)
+{
+    for(int y = 0; y < height; y++){
+        for(int x = 0; x < width; x++){
+            if(mask.at(x, y) != 0){
+                addPoint(x, y);
+            }
+        }
+    }
+}
+
+void
+IgnitionPattern::importMaskFromFile(const std::string &fileName)
+{
+    int headerSize = 6;
+    std::ifstream input_stream{fileName};
+    if(!input_stream){
+        std::cerr << "invalid ignition mask: " << fileName << " can not be read\n";
+        std::exit(1);
+    }
+    int width = 0;
+    int height = 0;
+    std::string noData;
+    std::string line;
+    for(int i = 0; i < headerSize; i++){
+        std::getline(input_stream, line);
+        std::stringstream header{line};
+        std::string key, value;
+        header >> key >> value;
+        if(key == "NCOLS") width = utility::asInteger(value);
+        if(key == "NROWS") height = utility::asInteger(value);
+        if(key == "NODATA_VALUE") noData = value;
+    }
+    if(width <= 0 || height <= 0){
+        std::cerr << "invalid ignition mask: " << fileName << " has no NCOLS and NROWS\n";
+        std::exit(1);
+    }
+    std::vector<std::uint8_t> mask(static_cast<size_t>(width) * height, 0);
+    size_t i = 0;
+    std::string value;
+    while(i < mask.size() && input_stream >> value){
+        mask[i++] = (value != noData && utility::asFloat(value) != 0.f) ? 1 : 0;
+    }
+    if(i < mask.size()){
+        std::cerr << "invalid ignition mask: " << fileName << " contains less than "
+                  << mask.size() << " values\n";
+        std::exit(1);
+    }
+    addMask(RasterView<std::uint8_t>{mask.data(), width}, width, height);
+}
+
+void
+IgnitionPattern::importFromFile(const std::string &fileName)
+{
+    auto reader = csv::Reader{',', '#'};
+    auto items = reader.parse(fileName);
+    if(items.empty()){
+        std::cerr << "invalid ignition pattern: " << fileName << " contains no ignition\n";
+        std::exit(1);
+    }
+    for(const auto &item : items){
+        addItem(item, fileName);
+    }
+}
+
+void
+IgnitionPattern::parse(const std::string &description)
+{
+    std::stringstream items{description};
+    std::string text;
+    while(std::getline(items, text, ';')){
+        std::vector<std::string> item;
+        std::stringstream values{text};
+        std::string value;
+        while(std::getline(values, value, ',')){
+            item.push_back(value);
+        }
+        if(!trimmed(text).empty()){
+            addItem(item, description);
+        }
+    }
+}
+
+const std::vector<IgnitionVertex> &
+IgnitionPattern::getVertices() const noexcept
+{
+    return m_vertices;
+}
+
+bool
+IgnitionPattern::empty() const noexcept
+{
+    return m_vertices.empty();
+}
+
+void
+IgnitionPattern::addItem(const std::vector<std::string> &item, const std::string &source)
+{
+    std::string kind = item.empty() ? std::string() : trimmed(item[0]);
+    if(kind == "point" && item.size() == 3){
+        addPoint(utility::asInteger(item[1]), utility::asInteger(item[2]));
+    } else if(kind == "line" && item.size() >= 5 && item.size() % 2 == 1){
+        std::vector<IgnitionVertex> points;
+        for(size_t i = 1; i < item.size(); i += 2){
+            points.push_back(IgnitionVertex{utility::asInteger(item[i]), utility::asInteger(item[i + 1])});
+        }
+        addPolyline(points);
+    } else if(kind == "mask" && item.size() == 2){
+        importMaskFromFile(trimmed(item[1]));
+    } else {
+        std::cerr << "invalid ignition pattern: " << source << " contains an item which is not "
+                  << "\"point,u,v\", \"line,u,v,u,v...\" or \"mask,file\"\n";
+        std::exit(1);
+    }
+}
+
+IgnitionSampler::IgnitionSampler(unsigned int seed)
+    : m_offset(0.0), m_weight(0.0), m_eligibleVertices()
+{
+    utility::RandomStream random{seed};
+    m_offset = random.random();
+}
+
+void
+IgnitionSampler::setLandscape(const LandscapeInterface &landscape, const FlammableComponents *components,
+                              int minimumComponentSize)
+{
+    int width = landscape.getWidth();
+    int height = landscape.getHeight();
+    std::uint32_t size = 1;
+    while(size < static_cast<std::uint32_t>(std::max(width, height))){
+        size *= 2;
+    }
+
+    //random ignition vertices are drawn from u in [0, width-1] and v in [0, height-1]
+    std::vector<std::pair<std::uint64_t, IgnitionVertex>> eligible;
+    for(int v = 0; v < height; v++){
+        for(int u = 0; u < width; u++){
+            if(!canIgniteCell(landscape, u, v) && !canIgniteCell(landscape, u, v - 1) &&
+                    !canIgniteCell(landscape, u - 1, v - 1) && !canIgniteCell(landscape, u - 1, v)){
+                continue;
+            }
+            if(components && components->getSize(components->getComponentAtVertex(u, v)) < minimumComponentSize){
+                continue;
+            }
+            eligible.emplace_back(hilbertIndex(size, static_cast<std::uint32_t>(u),
+                                               static_cast<std::uint32_t>(v)), IgnitionVertex{u, v});
+        }
+    }
+    std::sort(eligible.begin(), eligible.end(),
+              [](const std::pair<std::uint64_t, IgnitionVertex> &a,
+                 const std::pair<std::uint64_t, IgnitionVertex> &b) { return a.first < b.first; });
+
+    m_eligibleVertices.clear();
+    m_eligibleVertices.reserve(eligible.size());
+    for(const auto &vertex : eligible){
+        m_eligibleVertices.push_back(vertex.second);
+    }
+    m_weight = static_cast<double>(eligible.size()) / (static_cast<double>(width) * height);
+}
+
+IgnitionVertex
+IgnitionSampler::sample(int run) const
+{
+    if(m_eligibleVertices.empty()){
+        return IgnitionVertex{0, 0};
+    }
+    //additive recurrence with the inverse golden ratio, a one-dimensional low-discrepancy sequence
+    constexpr double InverseGoldenRatio = 0.61803398874989484820;
+    double intPart;
+    double position = std::modf(m_offset + run * InverseGoldenRatio, &intPart);
+    size_t index = std::min(static_cast<size_t>(position * m_eligibleVertices.size()),
+                            m_eligibleVertices.size() - 1);
+    return m_eligibleVertices[index];
+}
+
+double
+IgnitionSampler::getWeight() const noexcept
+{
+    return m_weight;
+}
+
+bool
+IgnitionSampler::empty() const noexcept
+{
+    return m_eligibleVertices.empty();
+}
+
+}  // namespace wildland_firesim
@@ -0,0 +1,147 @@
+#ifndef WILDLAND_FIRESIM_IGNITION_H
+#define WILDLAND_FIRESIM_IGNITION_H
+
+#include <cstdint>
+#include <string>
+#include <unordered_set>
+#include <vector>
+#include "WFS_rasterlandscape.h"
+#include "landscape_interface.h"
+#include "WFS_components.h"
+
+namespace wildland_firesim {
+
+/*!
+ * \brief The IgnitionVertex struct
+ * vertex of the landscape grid; vertex (u, v) is the lower left corner of cell (u, v).
+ */
+struct IgnitionVertex {
+    int u;
+    int v;
+};
+
+/*!
+ * \brief The IgnitionPattern class
+ * collects the vertices of a fire lit at several places at once, e.g. the ignition lines of a
+ * prescribed burn. Vertices are added as points, polylines or raster masks; vertices added more
+ * than once are kept only the first time, so the order of the vertices is the order they were
+ * first added in.
+ *
+ * Patterns are read from a file or an option with one item per line (or separated by ';'):
+ *   point,<u>,<v>
+ *   line,<u>,<v>,<u>,<v>[,<u>,<v>...]   polyline through the given vertices
+ *   mask,<ascii-grid-file>              vertices (x, y) of the cells with a non-zero value
+ */
+class IgnitionPattern
+{
+public:
+    IgnitionPattern();
+
+    void addPoint(int u, int v);
+
+    /*!
+     * \brief addPolyline
+     * adds all vertices on the straight segments between consecutive points (Bresenham).
+     * \param points
+     */
+    void addPolyline(const std::vector<IgnitionVertex> &points);
+
+    /*!
+     * \brief addMask
+     * adds vertex (x, y) for each non-zero value of the mask.
+     * \param mask
+     * \param width
+     * \param height
+     */
+    void addMask(const RasterView<std::uint8_t> &mask, int width, int height);
+
+    /*!
+     * \brief importMaskFromFile
+     * reads a mask from an ascii-grid. Rows are in the order of the grids of an imported landscape.
+     * \param fileName
+     */
+    void importMaskFromFile(const std::string &fileName);
+
+    /*!
+     * \brief importFromFile
+     * reads the items of a pattern file; '#' starts a comment.
+     * \param fileName
+     */
+    void importFromFile(const std::string &fileName);
+
+    /*!
+     * \brief parse
+     * reads the items of a pattern given as text, items are separated by ';'.
+     * \param description
+     */
+    void parse(const std::string &description);
+
+    const std::vector<IgnitionVertex> &getVertices() const noexcept;
+
+    bool empty() const noexcept;
+
+private:
+    std::vector<IgnitionVertex> m_vertices;
+    std::unordered_set<std::uint64_t> m_addedVertices;
+
+    void addItem(const std::vector<std::string> &item, const std::string &source);
+};
+
+/*!
+ * \brief The IgnitionSampler class
+ * draws the ignition vertices of the runs of an ensemble from the vertices a wild fire can start at,
+ * i.e. those bordering a grass cell with the minimum fuel load. A random ignition vertex is mostly
+ * one of the others in patchy landscapes, and its fire dies at once.
+ *
+ * The eligible vertices are ordered along a Hilbert curve and run i takes the one at position
+ * frac(offset + i / golden ratio) of that order, a rotated low-discrepancy sequence: consecutive
+ * runs are spread evenly over the landscape instead of clustering by chance. The offset is drawn
+ * from the seed.
+ *
+ * Compared to a vertex drawn uniformly from all vertices, a run stands for the eligible fraction of
+ * them only, the others never burn anything. Weighting each run by getWeight() keeps burn
+ * probabilities and burned areas unbiased estimates of those of uniformly ignited fires.
+ *
+ * Given the flammable components of the landscape, vertices in components smaller than a minimum
+ * size can be left out as well. Their fires are then treated like those of vertices that can not
+ * ignite, which underestimates the burn probabilities of the cells of small components only.
+ */
+class IgnitionSampler
+{
+public:
+    explicit IgnitionSampler(unsigned int seed);
+
+    /*!
+     * \brief setLandscape
+     * collects the eligible vertices of the landscape of the next run.
+     * \param landscape
+     * \param components flammable components of the landscape, if vertices are screened by them
+     * \param minimumComponentSize number of cells a component of an eligible vertex needs at least
+     */
+    void setLandscape(const LandscapeInterface &landscape, const FlammableComponents *components = nullptr,
+                      int minimumComponentSize = 0);
+
+    /*!
+     * \brief sample
+     * \param run index of the run
+     * \return ignition vertex of the run, (0, 0) if no vertex is eligible
+     */
+    IgnitionVertex sample(int run) const;
+
+    /*!
+     * \brief getWeight
+     * \return number of eligible vertices divided by the number of all vertices
+     */
+    double getWeight() const noexcept;
+
+    bool empty() const noexcept;
+
+private:
+    double m_offset;
+    double m_weight;
+    std::vector<IgnitionVertex> m_eligibleVertices;
+};
+
+}  // namespace wildland_firesim
+
+#endif // WILDLAND_FIRESIM_IGNITION_H
@@ -1,8 +1,33 @@
 #include "WFS_landscape.h"
+#include "WFS_tracing.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <iomanip>
+#include <thread>
 
 namespace wildland_firesim {
+namespace {
+
+const char LandscapeCacheMagic[8] = {'S', 'A', 'F', 'I', 'M', 'L', 'S', '1'};
+
+//spreads the bits of a coordinate within a tile to every second bit
+std::size_t
+spreadBits(int value)
+{
+    auto bits = static_cast<std::size_t>(value);
+    bits = (bits | (bits << 8)) & 0x00FF00FFu;
+    bits = (bits | (bits << 4)) & 0x0F0F0F0Fu;
+    bits = (bits | (bits << 2)) & 0x33333333u;
+    bits = (bits | (bits << 1)) & 0x55555555u;
+    return bits;
+}
+
+}
 
 WFS_Landscape::WFS_Landscape()
+    : m_layout(CellLayout::RowMajor), m_tilesX(0)
 {}
 
 int
@@ -20,7 +45,51 @@ WFS_Landscape::getHeight() const noexcept
 Cell
 *WFS_Landscape::getCellInformation(int x, int y)
 {
-    return &cellInformation[static_cast<size_t>(y * m_width + x)];
+    return &cellInformation[cellIndex(x, y)];
+}
+
+std::size_t
+WFS_Landscape::getCellIndex(int x, int y) const noexcept
+{
+    return cellIndex(x, y);
+}
+
+std::size_t
+WFS_Landscape::cellIndex(int x, int y) const noexcept
+{
+    if(m_layout == CellLayout::RowMajor){
+        return static_cast<size_t>(y * m_width + x);
+    }
+    auto tile = static_cast<size_t>((y / LandscapeTileSize) * m_tilesX + x / LandscapeTileSize);
+    return tile * LandscapeTileSize * LandscapeTileSize +
+            ((spreadBits(y % LandscapeTileSize) << 1) | spreadBits(x % LandscapeTileSize));
+}
+
+void
+WFS_Landscape::setLayout(CellLayout layout)
+{
+    m_layout = layout;
+}
+
+CellLayout
+WFS_Landscape::getLayout() const noexcept
+{
+    return m_layout;
+}
+
+void
+WFS_Landscape::allocateCells(int width, int height)
+{
+    m_width = width;
+    m_height = height;
+    datasize = static_cast<size_t>(width * height);
+    m_tilesX = (width + LandscapeTileSize - 1) / LandscapeTileSize;
+    if(m_layout == CellLayout::RowMajor){
+        cellInformation.resize(datasize);
+    } else {
+        int tilesY = (height + LandscapeTileSize - 1) / LandscapeTileSize;
+        cellInformation.resize(static_cast<size_t>(m_tilesX) * tilesY * LandscapeTileSize * LandscapeTileSize);
+    }
 }
 
 int
@@ -74,27 +143,29 @@ WFS_Landscape::importLandscapeFromFile()
     //import vegetation data
     readASCIIgrid("GroundCover.asc");
     //resize landscape
-    m_width = width;
-    m_height = height;
-    datasize = static_cast<size_t>(width * height);
-    cellInformation.resize(datasize);
+    allocateCells(width, height);
     //set cell size
     m_cellSize = 30;
     //cellSize = specifiedCellSize;
+    //cell of the i-th value of a grid, the grid rows are stored as rows y = 0, 1, ...
+    auto cellOfGridValue = [this](size_t i) -> Cell & {
+        return cellInformation[cellIndex(static_cast<int>(i % static_cast<size_t>(m_width)),
+                                            static_cast<int>(i / static_cast<size_t>(m_width)))];
+    };
     //set vegetation type
-    for(size_t i = 0; i < cellInformation.size(); i++){
+    for(size_t i = 0; i < datasize; i++){
         if(utility::asInteger(extractedInformation[i]) == 0 ||
                 utility::asInteger(extractedInformation[i]) == 1 ||
                 utility::asInteger(extractedInformation[i]) == 6){
-            cellInformation[i].type = VegetationType::NonFlammable;
+            cellOfGridValue(i).type = VegetationType::NonFlammable;
         };
         if((utility::asInteger(extractedInformation[i]) == 2) ||
                 (utility::asInteger(extractedInformation[i]) == 3) ||
                 (utility::asInteger(extractedInformation[i]) == 4)){
-            cellInformation[i].type = VegetationType::Grass;
+            cellOfGridValue(i).type = VegetationType::Grass;
         };
         if(utility::asInteger(extractedInformation[i]) == 5 ){
-            cellInformation[i].type = VegetationType::NonFlammable;
+            cellOfGridValue(i).type = VegetationType::NonFlammable;
         };
     }
     //set dead biomass
@@ -113,8 +184,8 @@ WFS_Landscape::importLandscapeFromFile()
         std::cerr << "dimensions of grid files differ!";
         std::exit(1);
     }
-    for(size_t i = 0; i < cellInformation.size(); i++){
-        cellInformation[i].deadBiomass = utility::asFloat(extractedInformation[i]);
+    for(size_t i = 0; i < datasize; i++){
+        cellOfGridValue(i).deadBiomass = utility::asFloat(extractedInformation[i]);
     }
     //set live biomass
     readASCIIgrid("live-biomass.asc");
@@ -132,17 +203,23 @@ WFS_Landscape::importLandscapeFromFile()
         std::cerr << "dimensions of grid files differ!";
         std::exit(1);
     }
-    for(size_t i = 0; i < cellInformation.size(); i++){
-        cellInformation[i].liveBiomass = utility::asFloat(extractedInformation[i]);
+    for(size_t i = 0; i < datasize; i++){
+        cellOfGridValue(i).liveBiomass = utility::asFloat(extractedInformation[i]);
     }
     //set cell states
     for(auto &cell : cellInformation){
-        cell.state = CellState::Unburned;
+        cell.setState(CellState::Unburned, getStateEpoch());
     };
 }
 
 void
-WFS_Landscape::generateLandscapeFromFile(const std::string &fileName)
+WFS_Landscape::setCacheDirectory(const std::string &directory)
+{
+    m_cacheDirectory = directory;
+}
+
+void
+WFS_Landscape::generateLandscapeFromFile(const std::string &fileName, unsigned int seed, int numberOfThreads)
 {
 
     size_t NumberOfLandscapeCreationParameters = 10;
@@ -166,98 +243,235 @@ WFS_Landscape::generateLandscapeFromFile(const std::string &fileName)
     float degreeOfCuring = utility::asFloat(parameters[6][0]);
     //float variationOfCuring = utility::asFloat(parameters[7][0]);
     float clusterDensity = utility::asFloat(parameters[8][0]);
-    size_t meanClusterSize = static_cast<size_t>(utility::asInteger(parameters[9][0]));
+    int meanClusterSize = utility::asInteger(parameters[9][0]);
 
     //resize landscape
-    m_width = width;
-    m_height = height;
-    datasize = static_cast<size_t>(width * height);
-    cellInformation.resize(datasize);
+    allocateCells(width, height);
 
     //set cell size
     m_cellSize = specificatedCellSize;
 
-    //assign parameters to individual cells within landscape
+    //set biomass correspondent to vegetation type
+    auto assignVegetationParameters = [&](Cell &cell) {
+        cell.setState(CellState::Unburned, getStateEpoch());
+        if(cell.type == VegetationType::Grass){
+            cell.deadBiomass = equilibriumGrassFuelLoad*degreeOfCuring;
+            cell.liveBiomass = equilibriumGrassFuelLoad*(1-degreeOfCuring);
+        }
+        if(cell.type == VegetationType::NonFlammable){
+            cell.deadBiomass = 0.0;
+            cell.liveBiomass = 0.0;
+        }
+    };
 
-    //set vegetation type
-    //standard vegetation is grass
-    for(auto &cell : cellInformation){
-        cell.type = VegetationType::Grass; //use grass as standard vegetation type
-        cell.state = CellState::Unburned;
+    //a landscape generated before from the same parameters and seed is taken from the cache
+    std::string cacheFileName;
+    if(!m_cacheDirectory.empty()){
+        cacheFileName = landscapeCacheFileName(fileName, seed);
+        if(loadVegetationTypes(cacheFileName)){
+            //only the cells of the landscape, the padding of Z-order tiles has no vegetation type
+            for(int y = 0; y < m_height; y++)
+                for(int x = 0; x < m_width; x++){
+                    assignVegetationParameters(cellInformation[cellIndex(x, y)]);
+                }
+            return;
+        }
     }
 
     //vegetation type of certain number of cells is then changed according to percentage of the type,
     //cluster size and density.
-
-    if(percentageGrass < 1.f){
+    //clusters are squares of meanClusterSize cells around their central point which wrap around
+    //the landscape borders.
+    struct Cluster {
+        int x;
+        int y;
+    };
+    std::vector<Cluster> clusters;
+    if(percentageGrass < 1.f && meanClusterSize > 0){
         //calculate number of clusters
         int numberOfClusters = static_cast<int>(std::round((percentageNonFlammable * static_cast<float>(datasize)) /
                                                            (clusterDensity * meanClusterSize * meanClusterSize) ));
-        //create each cluster by assigning vegetation parameters to individual cells within landscape
-        for(int m = 0; m<numberOfClusters; m++){
-            //selection of random coordinates (central point in cluster)
-            int x = utility::random(m_width - 1);
-            int y = utility::random(m_height - 1);
-
-            //create vectors containing coordinates within range given by cluster size
-            //empty vectors of size meanClusterSize
-            std::vector<int> xRange(meanClusterSize);
-            std::vector<int> yRange(meanClusterSize);
-
-            //create sequences with coordinates
-            for(size_t i = 0; i < meanClusterSize; i++){
-                if(i<meanClusterSize/2){
-                    xRange[i] = x+static_cast<int>(i);
-                    if(xRange[i]>width) xRange[i] = xRange[i]-width;
-                    yRange[i] = y+static_cast<int>(i);
-                    if(yRange[i]>height) yRange[i] = yRange[i]-height ;
-                }else
-                {
-                    xRange[i] = x+static_cast<int>(i-meanClusterSize);
-                    if(xRange[i]< 0) xRange[i] = xRange[i]+width;
-                    yRange[i] = y+static_cast<int>(i-meanClusterSize);
-                    if(yRange[i]< 0) yRange[i] = yRange[i]+height;
-                }
-            }
+        //selection of random coordinates (central point in cluster)
+        utility::RandomStream random{seed, 0};
+        clusters.resize(static_cast<size_t>(std::max(numberOfClusters, 0)));
+        for(auto &cluster : clusters){
+            cluster.x = random.random(m_width - 1);
+            cluster.y = random.random(m_height - 1);
+        }
+    }
 
-            //get Cartesian product
-            std::vector<std::pair<int, int>> cartesianProduct;
-            for (size_t i = 0; i < meanClusterSize; i++)
-                for (size_t j = 0; j < meanClusterSize; j++)
-                {
-                    cartesianProduct.push_back(std::make_pair(xRange[i],yRange[j]));
-                }
-            // set vegetation type of respective cell
-            for(size_t i = 0; i < cartesianProduct.size(); i++){
-                Cell *cell = getCellInformation(std::get<0>(cartesianProduct[i]),
-                                                std::get<1>(cartesianProduct[i]));
-                if(clusterDensity > utility::random()){
-                    cell->type = VegetationType::NonFlammable;
-                }else
-                {
-                    if(percentageNonFlammable > random()){
-                        cell->type = VegetationType::NonFlammable;
+    //the landscape is divided into tiles of fixed size. Each tile draws from its own stream, so the
+    //landscape only depends on the seed and not on the number of threads.
+    int tilesX = (m_width + LandscapeTileSize - 1) / LandscapeTileSize;
+    int tilesY = (m_height + LandscapeTileSize - 1) / LandscapeTileSize;
+    int numberOfTiles = tilesX * tilesY;
+
+    //a cluster covers the coordinates [center - (size - size/2), center + size/2) in each dimension,
+    //split in at most two intervals if it wraps around a border
+    auto clusterIntervals = [meanClusterSize](int center, int extent, int intervals[2][2]) {
+        if(meanClusterSize >= extent){
+            intervals[0][0] = 0;
+            intervals[0][1] = extent;
+            return 1;
+        }
+        int begin = center - (meanClusterSize - meanClusterSize / 2);
+        int end = begin + meanClusterSize;
+        int count = 0;
+        if(begin < 0){
+            intervals[count][0] = begin + extent;
+            intervals[count][1] = extent;
+            count++;
+            begin = 0;
+        }
+        if(end > extent){
+            intervals[count][0] = 0;
+            intervals[count][1] = end - extent;
+            count++;
+            end = extent;
+        }
+        intervals[count][0] = begin;
+        intervals[count][1] = end;
+        return count + 1;
+    };
+
+    //assign the clusters to the tiles they overlap, keeping their order
+    std::vector<std::vector<int>> clustersOfTile(static_cast<size_t>(numberOfTiles));
+    for(size_t m = 0; m < clusters.size(); m++){
+        int xIntervals[2][2];
+        int yIntervals[2][2];
+        int xCount = clusterIntervals(clusters[m].x, m_width, xIntervals);
+        int yCount = clusterIntervals(clusters[m].y, m_height, yIntervals);
+        for(int j = 0; j < yCount; j++)
+            for(int i = 0; i < xCount; i++)
+                for(int ty = yIntervals[j][0] / LandscapeTileSize; ty <= (yIntervals[j][1] - 1) / LandscapeTileSize; ty++)
+                    for(int tx = xIntervals[i][0] / LandscapeTileSize; tx <= (xIntervals[i][1] - 1) / LandscapeTileSize; tx++){
+                        auto &tileClusters = clustersOfTile[static_cast<size_t>(ty * tilesX + tx)];
+                        if(tileClusters.empty() || tileClusters.back() != static_cast<int>(m)){
+                            tileClusters.push_back(static_cast<int>(m));
+                        }
                     }
+    }
+
+    std::atomic<int> nextTile{0};
+    auto worker = [&]() {
+        WILDLAND_TRACE_SPAN("generateLandscapeTiles");
+        for(int tile = nextTile++; tile < numberOfTiles; tile = nextTile++){
+            int x0 = (tile % tilesX) * LandscapeTileSize;
+            int y0 = (tile / tilesX) * LandscapeTileSize;
+            int x1 = std::min(x0 + LandscapeTileSize, m_width);
+            int y1 = std::min(y0 + LandscapeTileSize, m_height);
+
+            //standard vegetation is grass
+            for(int y = y0; y < y1; y++)
+                for(int x = x0; x < x1; x++){
+                    cellInformation[cellIndex(x, y)].type = VegetationType::Grass;
                 }
+
+            //stamp the clusters into the tile
+            utility::RandomStream random{seed, static_cast<unsigned int>(tile + 1)};
+            for(int m : clustersOfTile[static_cast<size_t>(tile)]){
+                int xIntervals[2][2];
+                int yIntervals[2][2];
+                int xCount = clusterIntervals(clusters[static_cast<size_t>(m)].x, m_width, xIntervals);
+                int yCount = clusterIntervals(clusters[static_cast<size_t>(m)].y, m_height, yIntervals);
+                for(int j = 0; j < yCount; j++)
+                    for(int i = 0; i < xCount; i++){
+                        int cx0 = std::max(xIntervals[i][0], x0);
+                        int cx1 = std::min(xIntervals[i][1], x1);
+                        int cy0 = std::max(yIntervals[j][0], y0);
+                        int cy1 = std::min(yIntervals[j][1], y1);
+                        for(int y = cy0; y < cy1; y++)
+                            for(int x = cx0; x < cx1; x++){
+                                if(clusterDensity > random.random()){
+                                    cellInformation[cellIndex(x, y)].type = VegetationType::NonFlammable;
+                                }
+                            }
+                    }
             }
+
+            for(int y = y0; y < y1; y++)
+                for(int x = x0; x < x1; x++){
+                    assignVegetationParameters(cellInformation[cellIndex(x, y)]);
+                }
         }
+    };
+
+    numberOfThreads = std::max(1, std::min(numberOfThreads, numberOfTiles));
+    std::vector<std::thread> threads;
+    for(int i = 1; i < numberOfThreads; i++){
+        threads.emplace_back(worker);
     }
-    for(auto &cell : cellInformation){
-        //set biomass correspondent to vegetation type
-        if(cell.type == VegetationType::Grass){
-            cell.deadBiomass = equilibriumGrassFuelLoad*degreeOfCuring;
-            cell.liveBiomass = equilibriumGrassFuelLoad*(1-degreeOfCuring);
-        }
-        /*if(cell.type == VegetationType::YoungWoody){
-            cell.deadBiomass = deadYoungWoodyBiomass;
-            cell.liveBiomass = liveYoungWoodyBiomass;
-        }
-        */
-        if(cell.type == VegetationType::NonFlammable){
-            cell.deadBiomass = 0.0;
-            cell.liveBiomass = 0.0;
+    worker();
+    for(auto &thread : threads){
+        thread.join();
+    }
+
+    if(!cacheFileName.empty() && !saveVegetationTypes(cacheFileName)){
+        std::cerr << "landscape could not be cached in " << cacheFileName << "\n";
+    }
+}
+
+std::string
+WFS_Landscape::landscapeCacheFileName(const std::string &parameterFileName, unsigned int seed) const
+{
+    //FNV-1a hash of the parameter file content
+    std::ifstream parameterFile{parameterFileName, std::ios::binary};
+    std::uint64_t hash = 14695981039346656037ull;
+    char c;
+    while(parameterFile.get(c)){
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 1099511628211ull;
+    }
+    std::stringstream ss;
+    ss << m_cacheDirectory << "/landscape-" << std::hex << std::setw(16) << std::setfill('0') << hash
+       << std::dec << "-" << seed << ".bin";
+    return ss.str();
+}
+
+bool
+WFS_Landscape::saveVegetationTypes(const std::string &fileName) const
+{
+    std::ofstream file{fileName, std::ios::binary};
+    if(!file){
+        return false;
+    }
+    std::int32_t header[3] = {m_width, m_height, m_cellSize};
+    file.write(LandscapeCacheMagic, sizeof(LandscapeCacheMagic));
+    file.write(reinterpret_cast<const char *>(header), sizeof(header));
+    std::vector<char> types(datasize);
+    for(int y = 0; y < m_height; y++)
+        for(int x = 0; x < m_width; x++){
+            types[static_cast<size_t>(y * m_width + x)] = static_cast<char>(cellInformation[cellIndex(x, y)].type);
         }
+    file.write(types.data(), static_cast<std::streamsize>(types.size()));
+    return static_cast<bool>(file);
+}
+
+bool
+WFS_Landscape::loadVegetationTypes(const std::string &fileName)
+{
+    std::ifstream file{fileName, std::ios::binary};
+    if(!file){
+        return false;
     }
+    char magic[sizeof(LandscapeCacheMagic)];
+    std::int32_t header[3];
+    file.read(magic, sizeof(magic));
+    file.read(reinterpret_cast<char *>(header), sizeof(header));
+    if(!file || std::memcmp(magic, LandscapeCacheMagic, sizeof(magic)) != 0 ||
+            header[0] != m_width || header[1] != m_height || header[2] != m_cellSize){
+        return false;
+    }
+    std::vector<char> types(datasize);
+    file.read(types.data(), static_cast<std::streamsize>(types.size()));
+    if(!file){
+        return false;
+    }
+    for(int y = 0; y < m_height; y++)
+        for(int x = 0; x < m_width; x++){
+            cellInformation[cellIndex(x, y)].type = static_cast<VegetationType>(types[static_cast<size_t>(y * m_width + x)]);
+        }
+    return true;
 }
 
 }  // namespace wildland_firesim
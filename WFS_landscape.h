@@ -12,6 +12,20 @@
 
 namespace wildland_firesim {
 
+constexpr int LandscapeTileSize = 64;
+
+/*!
+ * \brief The CellLayout enum
+ * order in which a WFS_Landscape stores its cells.
+ */
+enum class CellLayout {
+    //row by row
+    RowMajor,
+    //tiles of LandscapeTileSize x LandscapeTileSize cells row by row, the cells of a tile along a
+    //Z-order (Morton) curve, so cells close to each other are mostly stored close to each other
+    ZOrderTiles
+};
+
 /*!
  * \brief The WFS_Landscape class
  * is derived from the landscape_interface class. It contains all relevant landscape information for the fire
@@ -27,9 +41,31 @@ public:
      * to generates a landscape from a parameter file specified by the committed file name.
      * Grass-dominated vegetation is used as the default vegetation type. If such is specified,
      * rectangular, non-flammable vegetation clusters are placed within the landscape.
+     * The clusters are stamped into tiles of the landscape in parallel. Each tile draws from its
+     * own random stream, so the same seed yields the same landscape for any number of threads.
+     * If a cache directory is set, the landscape is taken from or stored in the cache.
      * \param fileName
+     * \param seed
+     * \param numberOfThreads
      */
-    void generateLandscapeFromFile(const std::string &fileName);
+    void generateLandscapeFromFile(const std::string &fileName, unsigned int seed, int numberOfThreads);
+
+    /*!
+     * \brief setCacheDirectory
+     * sets the directory of generated landscapes, keyed by parameter file content and seed.
+     * \param directory
+     */
+    void setCacheDirectory(const std::string &directory);
+
+    /*!
+     * \brief setLayout
+     * sets the order in which the cells of the next generated or imported landscape are stored. The
+     * layout does not change the landscape or the fires burning in it, only where cells are in memory.
+     * \param layout
+     */
+    void setLayout(CellLayout layout);
+
+    CellLayout getLayout() const noexcept;
 
     /*!
      * \brief importLandscapeFromFile
@@ -68,8 +104,12 @@ public:
      */
     int getCellSize() const noexcept override;
 
+    std::size_t getCellIndex(int x, int y) const noexcept override;
+
 private:
     std::vector<Cell> cellInformation;
+    CellLayout m_layout;
+    int m_tilesX;
 
     //Landscape dimensions
     int m_width;
@@ -77,6 +117,21 @@ private:
     int m_cellSize;
 
     std::size_t datasize;
+
+    std::string m_cacheDirectory;
+
+    std::size_t cellIndex(int x, int y) const noexcept;
+
+    /*!
+     * \brief allocateCells
+     * sets the dimensions and allocates the cells in the layout, including the cells padding the
+     * last tiles.
+     */
+    void allocateCells(int width, int height);
+
+    std::string landscapeCacheFileName(const std::string &parameterFileName, unsigned int seed) const;
+    bool saveVegetationTypes(const std::string &fileName) const;
+    bool loadVegetationTypes(const std::string &fileName);
 };
 
 }  // namespace wildland_firesim
@@ -1,4 +1,6 @@
 #include "WFS_output.h"
+#include "WFS_tracing.h"
+#include "WFS_probes.h"
 #include <sstream>
 #include <fstream>
 
@@ -20,8 +22,10 @@ Output::setfileName(std::string baseName, std::string extention, int i)
 
 //functions for printing map to ASCII grid
 void
-Output::writeBurnMapToASCII(LandscapeInterface &landscape, std::string fileName)
+Output::writeBurnMapToASCII(const LandscapeInterface &landscape, std::string fileName)
 {
+    WILDLAND_TRACE_SPAN("writeBurnMap");
+    WILDLAND_PROBE1(output__begin, fileName.c_str());
     // create variable for output file stream
     std::ofstream burnDataFile;
     //open output file stream
@@ -37,15 +41,43 @@ Output::writeBurnMapToASCII(LandscapeInterface &landscape, std::string fileName)
 
     for (int y = (landscape.getHeight()-1); y >= 0; y--)
         for (int x = 0; x <landscape.getWidth(); x++) {
-            burnDataFile << static_cast<int>(landscape.getCellInformation(x,y)->state) << " ";
+            burnDataFile << static_cast<int>(landscape.getCellInformation(x,y)->getState(landscape.getStateEpoch())) << " ";
         }
     burnDataFile << "\n";
     burnDataFile.close();
+    WILDLAND_PROBE1(output__end, fileName.c_str());
 }
 
 void
-Output::writeVegetationMapToASCII(LandscapeInterface &landscape, std::string fileName)
+Output::writeBurnMapToASCII(const std::vector<std::uint8_t> &burnMap, int width, int height,
+                            std::string fileName)
 {
+    WILDLAND_TRACE_SPAN("writeBurnMap");
+    WILDLAND_PROBE1(output__begin, fileName.c_str());
+    std::ofstream burnDataFile;
+    burnDataFile.open(fileName);
+
+    burnDataFile << "NCOLS " << width << std::endl;
+    burnDataFile << "NROWS " << height << std::endl;
+    burnDataFile << "XLLCORNER " << "0"  << std::endl;
+    burnDataFile << "YLLCORNER " << "0"  << std::endl;
+    burnDataFile << "CELLSIZE " << "1" << std::endl;
+    burnDataFile << "NODATA_VALUE " << "-9999" << std::endl;
+
+    for (int y = (height-1); y >= 0; y--)
+        for (int x = 0; x < width; x++) {
+            burnDataFile << static_cast<int>(burnMap[static_cast<size_t>(y) * width + x]) << " ";
+        }
+    burnDataFile << "\n";
+    burnDataFile.close();
+    WILDLAND_PROBE1(output__end, fileName.c_str());
+}
+
+void
+Output::writeVegetationMapToASCII(const LandscapeInterface &landscape, std::string fileName)
+{
+    WILDLAND_TRACE_SPAN("writeVegetationMap");
+    WILDLAND_PROBE1(output__begin, fileName.c_str());
     std::ofstream vegetationTypeDataFile;
     //vegetationTypeDataFile.open("output/"+fileName);
     vegetationTypeDataFile.open(fileName);
@@ -62,13 +94,16 @@ Output::writeVegetationMapToASCII(LandscapeInterface &landscape, std::string fil
         }
     vegetationTypeDataFile << "\n";
     vegetationTypeDataFile.close();
+    WILDLAND_PROBE1(output__end, fileName.c_str());
 }
 
 
 //functions to write csv-files
 void
-Output::writeVegetationDataToCSV(LandscapeInterface &landscape, std::string fileName)
+Output::writeVegetationDataToCSV(const LandscapeInterface &landscape, std::string fileName)
 {
+    WILDLAND_TRACE_SPAN("writeVegetationData");
+    WILDLAND_PROBE1(output__begin, fileName.c_str());
     std::ofstream vegetationDataFile;
     //vegetationDataFile.open("output/"+fileName);
     vegetationDataFile.open(fileName);
@@ -87,11 +122,14 @@ Output::writeVegetationDataToCSV(LandscapeInterface &landscape, std::string file
             vegetationDataFile << "\n";
         }
     vegetationDataFile.close();
+    WILDLAND_PROBE1(output__end, fileName.c_str());
 }
 
 void
-Output::writeBurnDataToCSV(LandscapeInterface &landscape, Fire &fire, std::string fileName)
+Output::writeBurnDataToCSV(const LandscapeInterface &landscape, const Fire &fire, std::string fileName)
 {
+    WILDLAND_TRACE_SPAN("writeBurnData");
+    WILDLAND_PROBE1(output__begin, fileName.c_str());
     std::ofstream burnDataFile;
     //burnDataFile.open("output/"+fileName);
     burnDataFile.open(fileName);
@@ -101,7 +139,7 @@ Output::writeBurnDataToCSV(LandscapeInterface &landscape, Fire &fire, std::strin
     for (int y = (landscape.getHeight()-1); y >= 0; y--)
         for (int x = 0; x <landscape.getWidth(); x++) {
             burnDataFile << x << "," << y << ",";
-            CellState state = landscape.getCellInformation(x,y)->state;
+            CellState state = landscape.getCellInformation(x,y)->getState(landscape.getStateEpoch());
             burnDataFile << static_cast<int>(state) << ",";
 
             if(state==CellState::Burning){
@@ -117,11 +155,53 @@ Output::writeBurnDataToCSV(LandscapeInterface &landscape, Fire &fire, std::strin
             burnDataFile << "\n";
         }
     burnDataFile.close();
+    WILDLAND_PROBE1(output__end, fileName.c_str());
+}
+
+void
+Output::writeBurnedCellsToCSV(const LandscapeInterface &landscape, const Fire &fire, std::string fileName)
+{
+    WILDLAND_TRACE_SPAN("writeBurnedCells");
+    WILDLAND_PROBE1(output__begin, fileName.c_str());
+    const CellBounds &bounds = fire.getTouchedBounds();
+    int boundsWidth = bounds.maxX - bounds.minX + 1;
+    //intensities of the burning cells within the bounds
+    std::vector<float> intensity;
+    if(!bounds.empty()){
+        intensity.assign(static_cast<size_t>(boundsWidth) * (bounds.maxY - bounds.minY + 1), 0.f);
+    }
+    for(const auto &burningCell : fire.burningCellInformationVector){
+        intensity[static_cast<size_t>(burningCell.yCoord - bounds.minY) * boundsWidth +
+                static_cast<size_t>(burningCell.xCoord - bounds.minX)] = burningCell.meanFirelineIntensity;
+    }
+
+    std::ofstream burnDataFile;
+    burnDataFile.open(fileName);
+    //header
+    burnDataFile << "x,y,state,intensity" << "\n";
+    //data
+    for (int y = bounds.maxY; y >= bounds.minY; y--)
+        for (int x = bounds.minX; x <= bounds.maxX; x++) {
+            CellState state = landscape.getCellInformation(x,y)->getState(landscape.getStateEpoch());
+            if(state == CellState::Unburned) continue;
+            burnDataFile << x << "," << y << "," << static_cast<int>(state) << ",";
+            if(state == CellState::Burning){
+                burnDataFile << intensity[static_cast<size_t>(y - bounds.minY) * boundsWidth +
+                                          static_cast<size_t>(x - bounds.minX)];
+            }else{
+                burnDataFile << "0.0";
+            }
+            burnDataFile << "\n";
+        }
+    burnDataFile.close();
+    WILDLAND_PROBE1(output__end, fileName.c_str());
 }
 
 void
 Output::writeFireWeatherDataToCSV(std::vector<std::string> weatherData , std::string fileName)
 {
+    WILDLAND_TRACE_SPAN("writeFireWeatherData");
+    WILDLAND_PROBE1(output__begin, fileName.c_str());
     std::ofstream weatherDataFile;
     //weatherDataFile.open("output/"+fileName);
     weatherDataFile.open(fileName);
@@ -130,6 +210,7 @@ Output::writeFireWeatherDataToCSV(std::vector<std::string> weatherData , std::st
         weatherDataFile << weatherData[i] << "\n";
     }
     weatherDataFile.close();
+    WILDLAND_PROBE1(output__end, fileName.c_str());
 }
 
 //functions to store data in strings
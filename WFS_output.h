@@ -1,6 +1,7 @@
 #ifndef FIREMAP_H
 #define FIREMAP_H
 
+#include <cstdint>
 #include "globals.h"
 #include "cell.h"
 #include "fire.h"
@@ -21,21 +22,31 @@ public:
      * \param landscape
      * \param fileName
      */
-    void writeBurnMapToASCII(LandscapeInterface &landscape, std::string fileName);
+    void writeBurnMapToASCII(const LandscapeInterface &landscape, std::string fileName);
+    /*!
+     * \brief writeBurnMapToASCII
+     * Function to write a raster of cell states (row y at y * width) into an ascii-grid.
+     * \param burnMap
+     * \param width
+     * \param height
+     * \param fileName
+     */
+    void writeBurnMapToASCII(const std::vector<std::uint8_t> &burnMap, int width, int height,
+                             std::string fileName);
     /*!
      * \brief writeVegetationMapToASCII
      * Function to write vegetation types into an ascii-grid.
      * \param landscape
      * \param fileName
      */
-    void writeVegetationMapToASCII(LandscapeInterface &landscape, std::string fileName);
+    void writeVegetationMapToASCII(const LandscapeInterface &landscape, std::string fileName);
     /*!
      * \brief writeVegetationDataToCSV
      * Function to write vegetation parameters into a csv-Table
      * \param landscape
      * \param fileName
      */
-    void writeVegetationDataToCSV(LandscapeInterface &landscape, std::string fileName);
+    void writeVegetationDataToCSV(const LandscapeInterface &landscape, std::string fileName);
     /*!
      * \brief writeFireWeatherDataToCSV
      * Function to write weather data into a csv-Table
@@ -49,7 +60,16 @@ public:
      * \param landscape
      * \param fileName
      */
-    void writeBurnDataToCSV(LandscapeInterface &landscape, Fire &fire, std::string fileName);
+    void writeBurnDataToCSV(const LandscapeInterface &landscape, const Fire &fire, std::string fileName);
+    /*!
+     * \brief writeBurnedCellsToCSV
+     * Function to write the burn data of burning and burned out cells only, in the order of
+     * writeBurnDataToCSV. Only the cells touched by the fire are visited.
+     * \param landscape
+     * \param fire
+     * \param fileName
+     */
+    void writeBurnedCellsToCSV(const LandscapeInterface &landscape, const Fire &fire, std::string fileName);
     /*!
      * \brief setfileName
      * Function to generate file names.
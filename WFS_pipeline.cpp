@@ -0,0 +1,183 @@
+#include "WFS_pipeline.h"
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <thread>
+
+namespace wildland_firesim {
+namespace {
+
+double
+secondsSince(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+}
+
+Pipeline::Pipeline() : m_stages(), m_numberOfItems(0), m_nextItem(0),
+    m_lastItem(std::numeric_limits<std::size_t>::max()), m_itemsInFlight(0), m_freeSlots(), m_wallSeconds(0.0)
+{
+
+}
+
+void
+Pipeline::addStage(const std::string &name, int numberOfThreads, bool ordered,
+                   std::function<void(std::size_t, std::size_t)> work)
+{
+    Stage stage;
+    stage.statistics.name = name;
+    stage.statistics.numberOfThreads = ordered ? 1 : std::max(1, numberOfThreads);
+    stage.statistics.items = 0;
+    stage.statistics.busySeconds = 0.0;
+    stage.statistics.waitSeconds = 0.0;
+    stage.ordered = ordered;
+    stage.work = std::move(work);
+    stage.nextItem = 0;
+    m_stages.push_back(std::move(stage));
+}
+
+void
+Pipeline::run(std::size_t numberOfItems, std::size_t numberOfSlots)
+{
+    m_numberOfItems = numberOfItems;
+    m_nextItem = 0;
+    m_lastItem = std::numeric_limits<std::size_t>::max();
+    m_itemsInFlight = 0;
+    m_freeSlots.clear();
+    //slots are taken from the back, the first items get the first slots
+    for(std::size_t slot = std::max<std::size_t>(numberOfSlots, 1); slot > 0; slot--){
+        m_freeSlots.push_back(slot - 1);
+    }
+    for(auto &stage : m_stages){
+        stage.statistics.items = 0;
+        stage.statistics.busySeconds = 0.0;
+        stage.statistics.waitSeconds = 0.0;
+        stage.pending.clear();
+        stage.nextItem = 0;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> threads;
+    for(std::size_t s = 0; s < m_stages.size(); s++){
+        for(int t = 0; t < m_stages[s].statistics.numberOfThreads; t++){
+            threads.emplace_back(&Pipeline::work, this, s);
+        }
+    }
+    for(auto &thread : threads){
+        thread.join();
+    }
+    m_wallSeconds = secondsSince(start);
+}
+
+void
+Pipeline::stopAfter(std::size_t item)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_lastItem = std::min(m_lastItem, item);
+    m_changed.notify_all();
+}
+
+void
+Pipeline::work(std::size_t stageIndex)
+{
+    Stage &stage = m_stages[stageIndex];
+    std::unique_lock<std::mutex> lock(m_mutex);
+    std::pair<std::size_t, std::size_t> item;
+    while(takeItem(stageIndex, lock, &item)){
+        lock.unlock();
+        auto start = std::chrono::steady_clock::now();
+        stage.work(item.first, item.second);
+        double seconds = secondsSince(start);
+        lock.lock();
+        stage.statistics.items++;
+        stage.statistics.busySeconds += seconds;
+        if(stageIndex + 1 < m_stages.size()){
+            m_stages[stageIndex + 1].pending.insert(item);
+        } else {
+            releaseSlot(item.second);
+        }
+        m_changed.notify_all();
+    }
+}
+
+bool
+Pipeline::takeItem(std::size_t stageIndex, std::unique_lock<std::mutex> &lock,
+                   std::pair<std::size_t, std::size_t> *item)
+{
+    Stage &stage = m_stages[stageIndex];
+    for(;;){
+        //items after the last one are dropped before the stage
+        auto dropped = stage.pending.upper_bound(std::make_pair(m_lastItem, std::numeric_limits<std::size_t>::max()));
+        if(dropped != stage.pending.end()){
+            for(auto it = dropped; it != stage.pending.end(); ++it){
+                releaseSlot(it->second);
+            }
+            stage.pending.erase(dropped, stage.pending.end());
+            m_changed.notify_all();
+        }
+
+        bool moreItems = m_nextItem < m_numberOfItems && m_nextItem <= m_lastItem;
+        if(stageIndex == 0){
+            if(moreItems && !m_freeSlots.empty()){
+                *item = std::make_pair(m_nextItem++, m_freeSlots.back());
+                m_freeSlots.pop_back();
+                m_itemsInFlight++;
+                return true;
+            }
+        } else if(!stage.pending.empty() && (!stage.ordered || stage.pending.begin()->first == stage.nextItem)){
+            *item = *stage.pending.begin();
+            stage.pending.erase(stage.pending.begin());
+            stage.nextItem = item->first + 1;
+            return true;
+        }
+        if(!moreItems && m_itemsInFlight == 0){
+            return false;
+        }
+        auto start = std::chrono::steady_clock::now();
+        m_changed.wait(lock);
+        stage.statistics.waitSeconds += secondsSince(start);
+    }
+}
+
+void
+Pipeline::releaseSlot(std::size_t slot)
+{
+    m_freeSlots.push_back(slot);
+    m_itemsInFlight--;
+}
+
+std::vector<StageStatistics>
+Pipeline::getStatistics() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::vector<StageStatistics> statistics;
+    for(const auto &stage : m_stages){
+        statistics.push_back(stage.statistics);
+    }
+    return statistics;
+}
+
+double
+Pipeline::getWallSeconds() const noexcept
+{
+    return m_wallSeconds;
+}
+
+void
+Pipeline::writeStatisticsToCSV(const std::string &fileName) const
+{
+    std::ofstream statisticsFile;
+    statisticsFile.open(fileName);
+    statisticsFile << "stage,threads,items,busySeconds,waitSeconds,utilization" << "\n";
+    for(const auto &statistics : getStatistics()){
+        double capacity = m_wallSeconds * statistics.numberOfThreads;
+        statisticsFile << statistics.name << "," << statistics.numberOfThreads << ",";
+        statisticsFile << statistics.items << "," << statistics.busySeconds << ",";
+        statisticsFile << statistics.waitSeconds << ",";
+        statisticsFile << (capacity > 0.0 ? statistics.busySeconds / capacity : 0.0) << "\n";
+    }
+    statisticsFile.close();
+}
+
+}  // namespace wildland_firesim
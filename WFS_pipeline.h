@@ -0,0 +1,133 @@
+#ifndef WILDLAND_FIRESIM_PIPELINE_H
+#define WILDLAND_FIRESIM_PIPELINE_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <limits>
+#include <mutex>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace wildland_firesim {
+
+/*!
+ * \brief The StageStatistics struct
+ * summarizes the work of a pipeline stage.
+ */
+struct StageStatistics {
+    std::string name;
+    int numberOfThreads;
+    int items;
+    //time the threads of the stage spent working on items and waiting for them in s
+    double busySeconds;
+    double waitSeconds;
+};
+
+/*!
+ * \brief The Pipeline class
+ * passes numbered items (e.g. the runs of an ensemble) through a sequence of stages, each with its
+ * own number of threads, so the stages work on different items at the same time. An item is held in
+ * one of a fixed number of slots from entering the first stage until it leaves the last one; the slots
+ * bound the items in flight, so a slow stage holds back the stages before it. Ordered stages take the
+ * items one at a time and in their order, e.g. to draw from a shared random stream; the other stages
+ * take them as they arrive.
+ */
+class Pipeline
+{
+public:
+    Pipeline();
+
+    /*!
+     * \brief addStage
+     * appends a stage. work is called with the number of the item and its slot.
+     * \param name
+     * \param numberOfThreads ignored for ordered stages, which have one thread
+     * \param ordered
+     * \param work
+     */
+    void addStage(const std::string &name, int numberOfThreads, bool ordered,
+                  std::function<void(std::size_t, std::size_t)> work);
+
+    /*!
+     * \brief run
+     * passes items 0 to numberOfItems - 1 through all stages and returns when they are done.
+     * \param numberOfItems
+     * \param numberOfSlots
+     */
+    void run(std::size_t numberOfItems, std::size_t numberOfSlots);
+
+    /*!
+     * \brief stopAfter
+     * lets no item after the given one enter another stage; they are dropped. Can be called by a stage.
+     * \param item
+     */
+    void stopAfter(std::size_t item);
+
+    /*!
+     * \brief getStatistics
+     * \return statistics of each stage of the last run
+     */
+    std::vector<StageStatistics> getStatistics() const;
+
+    /*!
+     * \brief getWallSeconds
+     * \return duration of the last run in s
+     */
+    double getWallSeconds() const noexcept;
+
+    /*!
+     * \brief writeStatisticsToCSV
+     * writes one row per stage with its utilization, the fraction of the time of the run its threads
+     * worked. The stage with the highest utilization limits the pipeline.
+     * \param fileName
+     */
+    void writeStatisticsToCSV(const std::string &fileName) const;
+
+private:
+    struct Stage {
+        StageStatistics statistics;
+        bool ordered;
+        std::function<void(std::size_t, std::size_t)> work;
+        //items and their slots waiting for the stage
+        std::set<std::pair<std::size_t, std::size_t>> pending;
+        //next item of an ordered stage
+        std::size_t nextItem;
+    };
+
+    std::vector<Stage> m_stages;
+    mutable std::mutex m_mutex;
+    std::condition_variable m_changed;
+    std::size_t m_numberOfItems;
+    std::size_t m_nextItem;
+    std::size_t m_lastItem;
+    std::size_t m_itemsInFlight;
+    std::vector<std::size_t> m_freeSlots;
+    double m_wallSeconds;
+
+    /*!
+     * \brief work
+     * runs items through a stage until no item is left for it.
+     */
+    void work(std::size_t stageIndex);
+
+    /*!
+     * \brief takeItem
+     * waits for the next item of a stage, the mutex is held.
+     * \return false if no item is left for the stage
+     */
+    bool takeItem(std::size_t stageIndex, std::unique_lock<std::mutex> &lock,
+                  std::pair<std::size_t, std::size_t> *item);
+
+    /*!
+     * \brief releaseSlot
+     * ends an item that left the last stage or was dropped, the mutex is held.
+     */
+    void releaseSlot(std::size_t slot);
+};
+
+}  // namespace wildland_firesim
+
+#endif // WILDLAND_FIRESIM_PIPELINE_H
@@ -0,0 +1,27 @@
+#ifndef WILDLAND_FIRESIM_PROBES_H
+#define WILDLAND_FIRESIM_PROBES_H
+
+/*!
+ * Static tracepoints (USDT) of the provider "wildland_firesim" for perf, bpftrace and SystemTap, e.g.
+ * bpftrace -e 'usdt:./WildlandFireSimulator:wildland_firesim:step__end { @front = hist(arg0); }'
+ * They are compiled in with the CMake option WILDLAND_FIRESIM_USDT only; otherwise the macros expand
+ * to nothing.
+ *
+ * step__begin(frontSize), step__end(frontSize, ignitions)     Fire::spreadFire
+ * cell__ignite(x, y), cell__burnout(x, y)                     state changes of cells
+ * weather__begin(month, hour), weather__end(month, hour, windDirection)
+ *                                                             FireWeather::calculateFireWeather
+ * output__begin(fileName), output__end(fileName)              Output writers
+ */
+#ifdef WILDLAND_FIRESIM_USDT
+#include <sys/sdt.h>
+#define WILDLAND_PROBE1(name, a) DTRACE_PROBE1(wildland_firesim, name, a)
+#define WILDLAND_PROBE2(name, a, b) DTRACE_PROBE2(wildland_firesim, name, a, b)
+#define WILDLAND_PROBE3(name, a, b, c) DTRACE_PROBE3(wildland_firesim, name, a, b, c)
+#else
+#define WILDLAND_PROBE1(name, a)
+#define WILDLAND_PROBE2(name, a, b)
+#define WILDLAND_PROBE3(name, a, b, c)
+#endif
+
+#endif // WILDLAND_FIRESIM_PROBES_H
@@ -0,0 +1,74 @@
+#include "WFS_profiling.h"
+
+#ifdef WILDLAND_FIRESIM_PROFILING
+
+#include <algorithm>
+#include <fstream>
+
+namespace wildland_firesim {
+namespace profiling {
+namespace {
+
+const char *phaseNames[NumberOfPhases] = {
+    "spreadWithinCells", "burnOutCells", "igniteCells", "weatherUpdate", "landscapeLoad", "output"
+};
+
+const char *counterNames[NumberOfCounters] = {
+    "frontSize", "pointFireSources", "ignitionTests", "ignitions"
+};
+
+//every thread (e.g. of a scenario sweep) profiles its own runs
+thread_local RunProfile profile;
+
+}
+
+RunProfile &
+currentProfile()
+{
+    return profile;
+}
+
+void
+resetProfile()
+{
+    profile = RunProfile();
+}
+
+void
+endStep()
+{
+    for(int i = 0; i < NumberOfCounters; i++){
+        profile.counterTotal[i] += profile.counterCurrentStep[i];
+        profile.counterMaximum[i] = std::max(profile.counterMaximum[i], profile.counterCurrentStep[i]);
+        profile.counterCurrentStep[i] = 0;
+    }
+    profile.steps++;
+}
+
+void
+writeReport(const std::string &fileName)
+{
+    std::ofstream reportFile;
+    reportFile.open(fileName);
+    reportFile << "{\n  \"steps\": " << profile.steps << ",\n  \"phases\": {\n";
+    for(int i = 0; i < NumberOfPhases; i++){
+        reportFile << "    \"" << phaseNames[i] << "\": {\"calls\": " << profile.phaseCalls[i]
+                   << ", \"seconds\": " << profile.phaseSeconds[i] << "}"
+                   << (i + 1 < NumberOfPhases ? "," : "") << "\n";
+    }
+    reportFile << "  },\n  \"counters\": {\n";
+    for(int i = 0; i < NumberOfCounters; i++){
+        double mean = profile.steps > 0 ? static_cast<double>(profile.counterTotal[i]) / profile.steps : 0.0;
+        reportFile << "    \"" << counterNames[i] << "\": {\"total\": " << profile.counterTotal[i]
+                   << ", \"maxPerStep\": " << profile.counterMaximum[i]
+                   << ", \"meanPerStep\": " << mean << "}"
+                   << (i + 1 < NumberOfCounters ? "," : "") << "\n";
+    }
+    reportFile << "  }\n}\n";
+    reportFile.close();
+}
+
+}  // namespace profiling
+}  // namespace wildland_firesim
+
+#endif // WILDLAND_FIRESIM_PROFILING
@@ -0,0 +1,126 @@
+#ifndef WILDLAND_FIRESIM_PROFILING_H
+#define WILDLAND_FIRESIM_PROFILING_H
+
+/*!
+ * Per-phase timers and per-step counters of a simulation run. They are compiled in with the CMake
+ * option WILDLAND_FIRESIM_PROFILING only; otherwise the macros below expand to nothing.
+ */
+#ifdef WILDLAND_FIRESIM_PROFILING
+#define WILDLAND_PROFILE_PHASE(phase) \
+    wildland_firesim::profiling::PhaseTimer wildlandPhaseTimer{wildland_firesim::profiling::Phase::phase}
+#define WILDLAND_PROFILE_COUNT(counter, value) \
+    wildland_firesim::profiling::count(wildland_firesim::profiling::Counter::counter, (value))
+#define WILDLAND_PROFILE_END_STEP() wildland_firesim::profiling::endStep()
+#else
+#define WILDLAND_PROFILE_PHASE(phase)
+#define WILDLAND_PROFILE_COUNT(counter, value)
+#define WILDLAND_PROFILE_END_STEP()
+#endif
+
+#ifdef WILDLAND_FIRESIM_PROFILING
+
+#include <chrono>
+#include <string>
+
+namespace wildland_firesim {
+namespace profiling {
+
+enum class Phase {
+    SpreadWithinCells,
+    BurnOutCells,
+    IgniteCells,
+    WeatherUpdate,
+    LandscapeLoad,
+    Output,
+    Count
+};
+
+enum class Counter {
+    FrontSize,
+    PointFireSources,
+    IgnitionTests,
+    Ignitions,
+    Count
+};
+
+constexpr int NumberOfPhases = static_cast<int>(Phase::Count);
+constexpr int NumberOfCounters = static_cast<int>(Counter::Count);
+
+/*!
+ * \brief The RunProfile struct
+ * holds the accumulated time of each phase and the per-step counters of one run.
+ */
+struct RunProfile {
+    long long phaseCalls[NumberOfPhases] = {};
+    double phaseSeconds[NumberOfPhases] = {};
+    long long counterTotal[NumberOfCounters] = {};
+    long long counterMaximum[NumberOfCounters] = {};
+    long long counterCurrentStep[NumberOfCounters] = {};
+    int steps = 0;
+};
+
+/*!
+ * \brief currentProfile
+ * \return profile of the calling thread
+ */
+RunProfile &currentProfile();
+
+/*!
+ * \brief resetProfile
+ * clears the profile of the calling thread at the begin of a run.
+ */
+void resetProfile();
+
+inline void
+count(Counter counter, long long value)
+{
+    currentProfile().counterCurrentStep[static_cast<int>(counter)] += value;
+}
+
+/*!
+ * \brief endStep
+ * adds the counters of the current timestep to the totals.
+ */
+void endStep();
+
+/*!
+ * \brief writeReport
+ * writes the profile of the calling thread as JSON.
+ * \param fileName
+ */
+void writeReport(const std::string &fileName);
+
+/*!
+ * \brief The PhaseTimer class
+ * adds the time until the end of its scope to a phase.
+ */
+class PhaseTimer
+{
+public:
+    explicit PhaseTimer(Phase phase)
+        : m_phase(phase), m_start(std::chrono::steady_clock::now())
+    {
+    }
+
+    ~PhaseTimer()
+    {
+        RunProfile &profile = currentProfile();
+        profile.phaseCalls[static_cast<int>(m_phase)]++;
+        profile.phaseSeconds[static_cast<int>(m_phase)] +=
+                std::chrono::duration<double>(std::chrono::steady_clock::now() - m_start).count();
+    }
+
+    PhaseTimer(const PhaseTimer &) = delete;
+    PhaseTimer &operator=(const PhaseTimer &) = delete;
+
+private:
+    Phase m_phase;
+    std::chrono::steady_clock::time_point m_start;
+};
+
+}  // namespace profiling
+}  // namespace wildland_firesim
+
+#endif // WILDLAND_FIRESIM_PROFILING
+
+#endif // WILDLAND_FIRESIM_PROFILING_H
@@ -0,0 +1,103 @@
+#include "WFS_rasterlandscape.h"
+#include "utility.h"
+
+namespace wildland_firesim {
+
+RasterLandscape::RasterLandscape(const FuelRasters &fuel)
+    : m_fuel(fuel), m_slot(), m_cells(), m_cellIndex()
+{
+    WILDLAND_ASSERT(fuel.width > 0 && fuel.height > 0, "fuel rasters are empty");
+    WILDLAND_ASSERT(fuel.deadBiomass.data && fuel.liveBiomass.data, "biomass rasters are missing");
+    m_slot.assign(static_cast<size_t>(fuel.width) * fuel.height, -1);
+}
+
+int
+RasterLandscape::getWidth() const noexcept
+{
+    return m_fuel.width;
+}
+
+int
+RasterLandscape::getHeight() const noexcept
+{
+    return m_fuel.height;
+}
+
+int
+RasterLandscape::getCellSize() const noexcept
+{
+    return m_fuel.cellSize;
+}
+
+Cell *
+RasterLandscape::getCellInformation(int x, int y)
+{
+    int index = y * m_fuel.width + x;
+    int &slot = m_slot[static_cast<size_t>(index)];
+    if(slot < 0){
+        slot = static_cast<int>(m_cells.size());
+        m_cells.push_back(cellFromRasters(x, y));
+        m_cellIndex.push_back(index);
+    }
+    return &m_cells[static_cast<size_t>(slot)];
+}
+
+const Cell *
+RasterLandscape::getCellInformation(int x, int y) const
+{
+    int slot = m_slot[static_cast<size_t>(y) * m_fuel.width + x];
+    if(slot >= 0){
+        return &m_cells[static_cast<size_t>(slot)];
+    }
+    //one per thread, so concurrent readers do not share it
+    thread_local Cell untouchedCell;
+    untouchedCell = cellFromRasters(x, y);
+    return &untouchedCell;
+}
+
+size_t
+RasterLandscape::getNumberOfAccessedCells() const noexcept
+{
+    return m_cells.size();
+}
+
+const Cell &
+RasterLandscape::getAccessedCell(size_t i, int *x, int *y) const
+{
+    *x = m_cellIndex[i] % m_fuel.width;
+    *y = m_cellIndex[i] / m_fuel.width;
+    return m_cells[i];
+}
+
+void
+RasterLandscape::reset()
+{
+    for(int index : m_cellIndex){
+        m_slot[static_cast<size_t>(index)] = -1;
+    }
+    m_cells.clear();
+    m_cellIndex.clear();
+}
+
+Cell
+RasterLandscape::cellFromRasters(int x, int y) const
+{
+    Cell cell;
+    cell.type = (m_fuel.nonFlammable.data && m_fuel.nonFlammable.at(x, y) != 0) ?
+                VegetationType::NonFlammable : VegetationType::Grass;
+    cell.deadBiomass = m_fuel.deadBiomass.at(x, y);
+    cell.liveBiomass = m_fuel.liveBiomass.at(x, y);
+    cell.setState(CellState::Unburned, getStateEpoch());
+    return cell;
+}
+
+void
+RasterLandscape::resetAllCellStates()
+{
+    //cells not created yet are created unburned in the epoch they are accessed in
+    for(Cell &cell : m_cells){
+        cell.setState(CellState::Unburned, getStateEpoch());
+    }
+}
+
+}  // namespace wildland_firesim
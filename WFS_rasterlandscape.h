@@ -0,0 +1,113 @@
+#ifndef WILDLAND_FIRESIM_RASTERLANDSCAPE_H
+#define WILDLAND_FIRESIM_RASTERLANDSCAPE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <vector>
+#include "cell.h"
+#include "landscape_interface.h"
+
+namespace wildland_firesim {
+
+/*!
+ * \brief The RasterView struct
+ * refers to a raster owned by the caller. The value of cell (x, y) is data[y * stride + x].
+ */
+template<typename T>
+struct RasterView {
+    RasterView() : data(nullptr), stride(0) {}
+    RasterView(const T *rasterData, std::ptrdiff_t rasterStride) : data(rasterData), stride(rasterStride) {}
+
+    const T *data;
+    std::ptrdiff_t stride; // elements between the begin of two rows
+
+    const T &at(int x, int y) const
+    {
+        return data[static_cast<std::ptrdiff_t>(y) * stride + x];
+    }
+};
+
+/*!
+ * \brief The FuelRasters struct
+ * describes the fuel of a landscape by rasters of the caller. Biomass is given in g/m². Cells with
+ * a non-zero value in nonFlammable are not flammable; if the raster is not given, all cells are
+ * grass.
+ */
+struct FuelRasters {
+    int width = 0;
+    int height = 0;
+    int cellSize = 30;
+    RasterView<float> deadBiomass;
+    RasterView<float> liveBiomass;
+    RasterView<std::uint8_t> nonFlammable;
+};
+
+/*!
+ * \brief The RasterLandscape class
+ * is a landscape on the fuel rasters of the caller, which are neither copied nor modified. A cell is
+ * created from the rasters when the fire accesses it first, so the memory needed grows with the
+ * burned area and not with the size of the landscape (apart from an index of one int per cell).
+ */
+class RasterLandscape : public LandscapeInterface
+{
+public:
+    explicit RasterLandscape(const FuelRasters &fuel);
+
+    int getWidth() const noexcept override;
+    int getHeight() const noexcept override;
+    int getCellSize() const noexcept override;
+    Cell *getCellInformation(int x, int y) override;
+
+    /*!
+     * \brief getCellInformation
+     * does not create cells, so reading the landscape does not grow it: a cell the fire has not
+     * accessed is built unburned from the rasters into a cell of the calling thread, which is valid
+     * until the thread reads the next such cell.
+     * \param x
+     * \param y
+     * \return
+     */
+    const Cell *getCellInformation(int x, int y) const override;
+
+    /*!
+     * \brief getNumberOfAccessedCells
+     * \return number of cells accessed since construction or the last reset
+     */
+    size_t getNumberOfAccessedCells() const noexcept;
+
+    /*!
+     * \brief getAccessedCell
+     * \param i
+     * \param x column of the cell
+     * \param y row of the cell
+     * \return the i-th accessed cell
+     */
+    const Cell &getAccessedCell(size_t i, int *x, int *y) const;
+
+    /*!
+     * \brief reset
+     * forgets all accessed cells, so the next fire starts on the unburned rasters.
+     */
+    void reset();
+
+private:
+    FuelRasters m_fuel;
+    std::vector<int> m_slot; // index into m_cells per cell, -1 if not yet accessed
+    std::deque<Cell> m_cells; // pointers stay valid when cells are added
+    std::vector<int> m_cellIndex;
+
+    /*!
+     * \brief cellFromRasters
+     * \param x
+     * \param y
+     * \return unburned cell with the fuel of the rasters
+     */
+    Cell cellFromRasters(int x, int y) const;
+
+    void resetAllCellStates() override;
+};
+
+}  // namespace wildland_firesim
+
+#endif // WILDLAND_FIRESIM_RASTERLANDSCAPE_H
@@ -0,0 +1,209 @@
+#include "WFS_scheduler.h"
+#include <algorithm>
+
+namespace wildland_firesim {
+namespace {
+
+//scheduler and index of the calling thread, if it belongs to a scheduler
+thread_local const TaskScheduler *threadScheduler = nullptr;
+thread_local int threadIndex = 0;
+//bodies of tasks the calling thread is running
+thread_local int bodyDepth = 0;
+
+}
+
+TaskScheduler::TaskScheduler(int numberOfThreads)
+    : m_queues(), m_threads(), m_queuedTasks(0), m_sleepingWaiters(0), m_stop(false)
+{
+    numberOfThreads = std::max(1, numberOfThreads);
+    for(int i = 0; i < numberOfThreads; i++){
+        m_queues.emplace_back(new Queue());
+    }
+    for(int i = 1; i < numberOfThreads; i++){
+        m_threads.emplace_back(&TaskScheduler::workerLoop, this, i);
+    }
+}
+
+TaskScheduler::~TaskScheduler()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_sleepMutex);
+        m_stop = true;
+    }
+    m_wakeUp.notify_all();
+    for(auto &thread : m_threads){
+        thread.join();
+    }
+}
+
+int
+TaskScheduler::getNumberOfThreads() const noexcept
+{
+    return static_cast<int>(m_queues.size());
+}
+
+int
+TaskScheduler::getThreadIndex() const noexcept
+{
+    return threadScheduler == this ? threadIndex : 0;
+}
+
+void
+TaskScheduler::parallelFor(std::size_t begin, std::size_t end, std::size_t grainSize,
+                           const std::function<void(std::size_t, std::size_t)> &body)
+{
+    if(begin >= end){
+        return;
+    }
+    int index = getThreadIndex();
+    Loop loop;
+    loop.body = &body;
+    loop.grainSize = std::max<std::size_t>(grainSize, 1);
+    loop.remaining = end - begin;
+    loop.queued = 0;
+    //within a task only pieces of this loop are taken, so the task is not interrupted by others
+    const Loop *filter = bodyDepth > 0 ? &loop : nullptr;
+    execute(Task{&loop, begin, end}, index);
+    //help until the pieces taken by other threads are done
+    while(loop.remaining.load() > 0){
+        Task task;
+        if(takeTask(index, filter, &task)){
+            execute(task, index);
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(m_sleepMutex);
+        m_sleepingWaiters++;
+        m_waiterWakeUp.wait(lock, [this, &loop, filter]() {
+            return loop.remaining.load() == 0 || (filter ? loop.queued.load() : m_queuedTasks.load()) > 0;
+        });
+        m_sleepingWaiters--;
+    }
+}
+
+void
+TaskScheduler::execute(Task task, int index)
+{
+    while(task.end - task.begin > task.loop->grainSize){
+        std::size_t middle = task.begin + (task.end - task.begin) / 2;
+        {
+            Queue &queue = *m_queues[static_cast<size_t>(index)];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            queue.push(Task{task.loop, middle, task.end});
+        }
+        task.loop->queued++;
+        m_queuedTasks++;
+        if(!m_threads.empty()){
+            //taking the mutex orders the push before a thread going to sleep
+            std::lock_guard<std::mutex> lock(m_sleepMutex);
+            m_wakeUp.notify_one();
+            if(m_sleepingWaiters > 0){
+                m_waiterWakeUp.notify_all();
+            }
+        }
+        task.end = middle;
+    }
+    bodyDepth++;
+    (*task.loop->body)(task.begin, task.end);
+    bodyDepth--;
+    if((task.loop->remaining -= task.end - task.begin) == 0 && !m_threads.empty()){
+        //the waiter may return and end the loop at once, so only the scheduler is accessed here
+        std::lock_guard<std::mutex> lock(m_sleepMutex);
+        if(m_sleepingWaiters > 0){
+            m_waiterWakeUp.notify_all();
+        }
+    }
+}
+
+bool
+TaskScheduler::takeTask(int index, const Loop *loop, Task *task)
+{
+    if(m_queuedTasks.load() == 0){
+        return false;
+    }
+    {
+        Queue &queue = *m_queues[static_cast<size_t>(index)];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if(queue.size > 0 && (!loop || queue.newest().loop == loop)){
+            *task = queue.newest();
+            queue.popNewest();
+            task->loop->queued--;
+            m_queuedTasks--;
+            return true;
+        }
+    }
+    int numberOfQueues = getNumberOfThreads();
+    for(int i = 1; i < numberOfQueues; i++){
+        Queue &queue = *m_queues[static_cast<size_t>((index + i) % numberOfQueues)];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if(queue.size > 0 && (!loop || queue.oldest().loop == loop)){
+            *task = queue.oldest();
+            queue.popOldest();
+            task->loop->queued--;
+            m_queuedTasks--;
+            return true;
+        }
+    }
+    return false;
+}
+
+void
+TaskScheduler::workerLoop(int index)
+{
+    threadScheduler = this;
+    threadIndex = index;
+    for(;;){
+        Task task;
+        if(takeTask(index, nullptr, &task)){
+            execute(task, index);
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(m_sleepMutex);
+        m_wakeUp.wait(lock, [this]() { return m_stop || m_queuedTasks.load() > 0; });
+        if(m_stop){
+            return;
+        }
+    }
+}
+
+void
+TaskScheduler::Queue::push(const Task &task)
+{
+    if(size == tasks.size()){
+        //unroll the ring into a larger buffer
+        std::vector<Task> larger(std::max<std::size_t>(2 * tasks.size(), 16));
+        for(std::size_t i = 0; i < size; i++){
+            larger[i] = tasks[(first + i) % tasks.size()];
+        }
+        tasks.swap(larger);
+        first = 0;
+    }
+    tasks[(first + size) % tasks.size()] = task;
+    size++;
+}
+
+const TaskScheduler::Task &
+TaskScheduler::Queue::newest() const
+{
+    return tasks[(first + size - 1) % tasks.size()];
+}
+
+const TaskScheduler::Task &
+TaskScheduler::Queue::oldest() const
+{
+    return tasks[first];
+}
+
+void
+TaskScheduler::Queue::popNewest()
+{
+    size--;
+}
+
+void
+TaskScheduler::Queue::popOldest()
+{
+    first = (first + 1) % tasks.size();
+    size--;
+}
+
+}  // namespace wildland_firesim
@@ -0,0 +1,127 @@
+#ifndef WILDLAND_FIRESIM_SCHEDULER_H
+#define WILDLAND_FIRESIM_SCHEDULER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace wildland_firesim {
+
+/*!
+ * \brief The TaskScheduler class
+ * runs parallel loops on a fixed set of threads with work stealing. A loop is split in halves until
+ * the pieces are small enough; a thread works on its newest piece and pushes the other halves to its
+ * own queue, from which idle threads steal the oldest, i.e. largest, pieces. Loops can be nested, e.g.
+ * the fires of a sweep and the cells of a single fire: once only one large fire is left, the other
+ * threads steal pieces of its loops. A thread waiting for a loop it started within a task helps with
+ * the pieces of that loop only, so a task is never interrupted by an unrelated one; a thread waiting
+ * for a loop started outside of tasks, e.g. the one running a sweep, takes any piece. Threads without
+ * a piece to take sleep.
+ */
+class TaskScheduler
+{
+public:
+    /*!
+     * \brief TaskScheduler
+     * \param numberOfThreads including the thread calling parallelFor, so numberOfThreads - 1 threads
+     * are started
+     */
+    explicit TaskScheduler(int numberOfThreads);
+    ~TaskScheduler();
+
+    TaskScheduler(const TaskScheduler &) = delete;
+    TaskScheduler &operator=(const TaskScheduler &) = delete;
+
+    int getNumberOfThreads() const noexcept;
+
+    /*!
+     * \brief getThreadIndex
+     * \return index of the calling thread between 1 and getNumberOfThreads() - 1 for the threads of the
+     * scheduler and 0 for all other threads, e.g. to keep state per thread
+     */
+    int getThreadIndex() const noexcept;
+
+    /*!
+     * \brief parallelFor
+     * calls body with subranges of [begin, end) of at most grainSize items and returns when all are done.
+     * Can be called from within a body.
+     * \param begin
+     * \param end
+     * \param grainSize
+     * \param body
+     */
+    void parallelFor(std::size_t begin, std::size_t end, std::size_t grainSize,
+                     const std::function<void(std::size_t, std::size_t)> &body);
+
+private:
+    struct Loop {
+        const std::function<void(std::size_t, std::size_t)> *body;
+        std::size_t grainSize;
+        //items not yet done
+        std::atomic<std::size_t> remaining;
+        //pieces in the queues
+        std::atomic<std::size_t> queued;
+    };
+
+    struct Task {
+        Loop *loop;
+        std::size_t begin;
+        std::size_t end;
+    };
+
+    /*!
+     * \brief The Queue struct
+     * ring buffer of the tasks of a thread, oldest first. It keeps its capacity, so queueing does not
+     * allocate once it has grown.
+     */
+    struct Queue {
+        std::mutex mutex;
+        std::vector<Task> tasks;
+        std::size_t first = 0;
+        std::size_t size = 0;
+
+        void push(const Task &task);
+        const Task &newest() const;
+        const Task &oldest() const;
+        void popNewest();
+        void popOldest();
+    };
+
+    std::vector<std::unique_ptr<Queue>> m_queues;
+    std::vector<std::thread> m_threads;
+    std::atomic<int> m_queuedTasks;
+    std::mutex m_sleepMutex;
+    std::condition_variable m_wakeUp;
+    //threads sleeping in parallelFor until their loop is done or has a piece to take
+    std::condition_variable m_waiterWakeUp;
+    int m_sleepingWaiters;
+    bool m_stop;
+
+    void workerLoop(int index);
+
+    /*!
+     * \brief execute
+     * splits a task down to the grain size, queueing the other halves, and runs it.
+     */
+    void execute(Task task, int index);
+
+    /*!
+     * \brief takeTask
+     * takes the newest task of the own queue or steals the oldest task of another queue.
+     * \param index of the calling thread
+     * \param loop take only tasks of this loop, any task if null. Tasks of the loop queued behind
+     * those of other loops are left to the other threads.
+     * \param task
+     * \return false if there is none
+     */
+    bool takeTask(int index, const Loop *loop, Task *task);
+};
+
+}  // namespace wildland_firesim
+
+#endif // WILDLAND_FIRESIM_SCHEDULER_H
@@ -0,0 +1,394 @@
+#include "WFS_server.h"
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <iterator>
+#include <list>
+#include <set>
+#include <sstream>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include "WFS_output.h"
+
+namespace wildland_firesim {
+namespace {
+
+bool
+parseNumber(const std::string &text, double *value)
+{
+    char *end = nullptr;
+    errno = 0;
+    *value = std::strtod(text.c_str(), &end);
+    return !text.empty() && *end == '\0' && errno == 0;
+}
+
+bool
+parseInteger(const std::string &text, long *value)
+{
+    char *end = nullptr;
+    errno = 0;
+    *value = std::strtol(text.c_str(), &end, 10);
+    return !text.empty() && *end == '\0' && errno == 0;
+}
+
+}
+
+/*!
+ * \brief The Connection struct
+ * source of requests and destination of their results. Results of several workers are written
+ * under the lock, one line at a time.
+ */
+struct JobServer::Connection {
+    Connection(int input, int output) : inputFd(input), outputFd(output), pendingJobs(0)
+    {
+    }
+
+    void send(const std::string &line)
+    {
+        std::lock_guard<std::mutex> lock{writeMutex};
+        std::string message = line + "\n";
+        size_t written = 0;
+        while(written < message.size()){
+            ssize_t n = write(outputFd, message.data() + written, message.size() - written);
+            if(n < 0 && errno == EINTR) continue;
+            if(n <= 0) return; //the client has gone, the result is dropped
+            written += static_cast<size_t>(n);
+        }
+    }
+
+    int inputFd;
+    int outputFd;
+    std::mutex writeMutex;
+    int pendingJobs; // guarded by the mutex of the server
+};
+
+JobServer::JobServer(WFS_Landscape &landscape, const safim::FireSettings &settings,
+                     const FireWeatherVariables &defaultWeather, unsigned int seed)
+    : m_settings(settings), m_defaultWeather(defaultWeather), m_seed(seed), m_weatherBank(nullptr),
+      m_month(Month::January), m_stopping(false)
+{
+    //the jobs read the fuel from rasters, every fire starts on the unburned landscape
+    int width = landscape.getWidth();
+    int height = landscape.getHeight();
+    size_t numberOfCells = static_cast<size_t>(width) * height;
+    m_deadBiomass.resize(numberOfCells);
+    m_liveBiomass.resize(numberOfCells);
+    m_nonFlammable.resize(numberOfCells);
+    for(int y = 0; y < height; y++){
+        for(int x = 0; x < width; x++){
+            const Cell *cell = landscape.getCellInformation(x, y);
+            size_t index = static_cast<size_t>(y) * width + x;
+            m_deadBiomass[index] = cell->deadBiomass;
+            m_liveBiomass[index] = cell->liveBiomass;
+            m_nonFlammable[index] = cell->type == VegetationType::NonFlammable ? 1 : 0;
+        }
+    }
+    m_fuel.width = width;
+    m_fuel.height = height;
+    m_fuel.cellSize = landscape.getCellSize();
+    m_fuel.deadBiomass = RasterView<float>(m_deadBiomass.data(), width);
+    m_fuel.liveBiomass = RasterView<float>(m_liveBiomass.data(), width);
+    m_fuel.nonFlammable = RasterView<std::uint8_t>(m_nonFlammable.data(), width);
+}
+
+void
+JobServer::setWeatherBank(const WeatherTrajectoryBank *bank, Month month)
+{
+    m_weatherBank = bank;
+    m_month = month;
+}
+
+void
+JobServer::startWorkers(int numberOfThreads)
+{
+    m_stopping = false;
+    for(int i = 0; i < std::max(1, numberOfThreads); i++){
+        m_workers.emplace_back(&JobServer::runWorker, this);
+    }
+}
+
+void
+JobServer::stopWorkers()
+{
+    {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        m_stopping = true;
+    }
+    m_jobAvailable.notify_all();
+    for(auto &worker : m_workers){
+        worker.join();
+    }
+    m_workers.clear();
+}
+
+void
+JobServer::runWorker()
+{
+    //the landscape of a worker is reused for all its jobs
+    RasterLandscape landscape{m_fuel};
+    for(;;){
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock{m_mutex};
+            m_jobAvailable.wait(lock, [this]() { return m_stopping || !m_jobs.empty(); });
+            if(m_jobs.empty()) return;
+            job = std::move(m_jobs.front());
+            m_jobs.pop_front();
+        }
+        job.connection->send(runJob(job.request, landscape));
+        {
+            std::lock_guard<std::mutex> lock{m_mutex};
+            job.connection->pendingJobs--;
+        }
+        m_jobFinished.notify_all();
+    }
+}
+
+void
+JobServer::readRequests(const std::shared_ptr<Connection> &connection, bool *shutdownRequested)
+{
+    *shutdownRequested = false;
+    std::string buffered;
+    char buffer[4096];
+    bool endOfInput = false;
+    while(!endOfInput && !*shutdownRequested){
+        ssize_t n = read(connection->inputFd, buffer, sizeof(buffer));
+        if(n < 0 && errno == EINTR) continue;
+        if(n <= 0){
+            //a last request may lack the line break
+            endOfInput = true;
+            buffered += '\n';
+        } else {
+            buffered.append(buffer, static_cast<size_t>(n));
+        }
+        size_t begin = 0;
+        for(size_t end = buffered.find('\n'); end != std::string::npos; end = buffered.find('\n', begin)){
+            std::string line = buffered.substr(begin, end - begin);
+            begin = end + 1;
+            if(!line.empty() && line.back() == '\r') line.pop_back();
+            if(line.empty() || line[0] == '#') continue;
+            if(line == "shutdown"){
+                *shutdownRequested = true;
+                break;
+            }
+            {
+                std::lock_guard<std::mutex> lock{m_mutex};
+                connection->pendingJobs++;
+                m_jobs.push_back(Job{connection, line});
+            }
+            m_jobAvailable.notify_one();
+        }
+        buffered.erase(0, begin);
+    }
+    //all results are sent before the connection is closed
+    std::unique_lock<std::mutex> lock{m_mutex};
+    m_jobFinished.wait(lock, [&connection]() { return connection->pendingJobs == 0; });
+}
+
+std::string
+JobServer::runJob(const std::string &request, RasterLandscape &landscape)
+{
+    auto start = std::chrono::steady_clock::now();
+    std::string id = "-";
+    safim::FireSettings settings = m_settings;
+    settings.seed = m_seed;
+    settings.ignition = safim::Ignition::Random;
+    FireWeatherVariables weather = m_defaultWeather;
+    long trajectory = -1;
+    bool hasU = false;
+    bool hasV = false;
+    std::string burnMapFile;
+
+    std::istringstream tokens{request};
+    std::string token;
+    std::string error;
+    while(error.empty() && tokens >> token){
+        size_t separator = token.find('=');
+        if(separator == std::string::npos){
+            error = "expected key=value instead of " + token;
+            break;
+        }
+        std::string key = token.substr(0, separator);
+        std::string value = token.substr(separator + 1);
+        double number = 0.0;
+        long integer = 0;
+        if(key == "id"){
+            id = value;
+        } else if(key == "u" && parseInteger(value, &integer)){
+            settings.ignitionU = static_cast<int>(integer);
+            hasU = true;
+        } else if(key == "v" && parseInteger(value, &integer)){
+            settings.ignitionV = static_cast<int>(integer);
+            hasV = true;
+        } else if(key == "temperature" && parseNumber(value, &number)){
+            weather.temperature = static_cast<float>(number);
+        } else if(key == "rh" && parseNumber(value, &number)){
+            weather.relHumidity = static_cast<float>(number);
+        } else if(key == "wind" && parseNumber(value, &number)){
+            weather.windSpeed = static_cast<float>(number);
+        } else if(key == "direction" && parseInteger(value, &integer) && integer >= 1 && integer <= 8){
+            weather.windDirection = static_cast<int>(integer);
+        } else if(key == "trajectory" && parseInteger(value, &integer) && integer >= 0){
+            trajectory = integer;
+        } else if(key == "seed" && parseInteger(value, &integer) && integer >= 0){
+            settings.seed = static_cast<unsigned int>(integer);
+        } else if(key == "duration" && parseInteger(value, &integer) && integer > 0){
+            settings.maximalFireDuration = static_cast<int>(integer);
+        } else if(key == "burnmap" && !value.empty()){
+            burnMapFile = value;
+        } else {
+            error = "invalid value of " + key;
+        }
+    }
+    if(error.empty() && hasU != hasV){
+        error = "the ignition vertex needs u and v";
+    }
+    if(error.empty() && hasU && (settings.ignitionU < 0 || settings.ignitionU > m_fuel.width ||
+                                 settings.ignitionV < 0 || settings.ignitionV > m_fuel.height)){
+        error = "the ignition vertex is outside of the landscape";
+    }
+    std::vector<safim::Weather> hourlyWeather;
+    if(error.empty() && trajectory >= 0){
+        if(!m_weatherBank){
+            error = "no weather bank is loaded";
+        } else if(trajectory >= m_weatherBank->getNumberOfTrajectories()){
+            error = "the weather bank has no trajectory " + std::to_string(trajectory);
+        } else {
+            std::vector<FireWeatherVariables> trajectoryWeather;
+            m_weatherBank->getTrajectory(m_month, static_cast<int>(trajectory), &trajectoryWeather);
+            for(const FireWeatherVariables &hour : trajectoryWeather){
+                hourlyWeather.push_back(safim::Weather{hour.temperature, hour.relHumidity,
+                                                       hour.windSpeed, hour.windDirection});
+            }
+        }
+    } else {
+        hourlyWeather.push_back(safim::Weather{weather.temperature, weather.relHumidity,
+                                               weather.windSpeed, weather.windDirection});
+    }
+    if(!error.empty()){
+        return "id=" + id + " status=error message=" + error;
+    }
+    if(hasU){
+        settings.ignition = safim::Ignition::Vertex;
+    }
+
+    safim::FireResult result = safim::runFire(landscape, hourlyWeather, settings);
+    if(!burnMapFile.empty()){
+        Output output;
+        output.writeBurnMapToASCII(result.burnMap, result.width, result.height, burnMapFile);
+    }
+    double milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    std::ostringstream response;
+    response << "id=" << id << " status=ok ignited=" << result.numberOfCellsIgnited
+             << " burnedOut=" << result.numberOfCellsBurnedOut << " burning=" << result.numberOfCellsBurning
+             << " duration=" << result.duration << " timesteps=" << result.timesteps
+             << " meanIntensity=" << result.meanFirelineIntensity
+             << " maxIntensity=" << result.maximumFirelineIntensity << " milliseconds=" << milliseconds;
+    return response.str();
+}
+
+void
+JobServer::serveStream(int inputFd, int outputFd, int numberOfThreads)
+{
+    startWorkers(numberOfThreads);
+    auto connection = std::make_shared<Connection>(inputFd, outputFd);
+    bool shutdownRequested;
+    readRequests(connection, &shutdownRequested);
+    stopWorkers();
+}
+
+bool
+JobServer::serveSocket(const std::string &path, int numberOfThreads)
+{
+    sockaddr_un address;
+    std::memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if(path.size() >= sizeof(address.sun_path)){
+        std::cerr << "socket path too long: " << path << "\n";
+        return false;
+    }
+    std::strncpy(address.sun_path, path.c_str(), sizeof(address.sun_path) - 1);
+
+    int listenFd = socket(AF_UNIX, SOCK_STREAM, 0);
+    unlink(path.c_str());
+    if(listenFd < 0 || bind(listenFd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) != 0 ||
+            listen(listenFd, 16) != 0){
+        std::cerr << "cannot listen on " << path << ": " << std::strerror(errno) << "\n";
+        if(listenFd >= 0) close(listenFd);
+        return false;
+    }
+    //clients closing their connection early must not terminate the server
+    std::signal(SIGPIPE, SIG_IGN);
+    startWorkers(numberOfThreads);
+
+    //every connection is read by its own thread, joined once it has finished
+    struct ConnectionThread {
+        std::thread thread;
+        bool finished = false;
+    };
+    std::mutex connectionsMutex;
+    std::set<int> openConnections;
+    std::list<ConnectionThread> connectionThreads;
+    bool stopping = false;
+    for(;;){
+        int connectionFd = accept(listenFd, nullptr, nullptr);
+        if(connectionFd < 0){
+            if(errno == EINTR) continue;
+            break; //the listening socket was shut down
+        }
+        std::list<ConnectionThread> finishedThreads;
+        std::list<ConnectionThread>::iterator connectionThread;
+        {
+            std::lock_guard<std::mutex> lock{connectionsMutex};
+            for(auto it = connectionThreads.begin(); it != connectionThreads.end();){
+                auto next = std::next(it);
+                if(it->finished){
+                    finishedThreads.splice(finishedThreads.end(), connectionThreads, it);
+                }
+                it = next;
+            }
+            openConnections.insert(connectionFd);
+            if(stopping){
+                //accepted just before a shutdown request was served
+                shutdown(connectionFd, SHUT_RD);
+            }
+            connectionThread = connectionThreads.emplace(connectionThreads.end());
+        }
+        for(ConnectionThread &finished : finishedThreads){
+            finished.thread.join();
+        }
+        connectionThread->thread = std::thread([&, connectionFd, connectionThread]() {
+            bool shutdownRequested;
+            {
+                auto connection = std::make_shared<Connection>(connectionFd, connectionFd);
+                readRequests(connection, &shutdownRequested);
+            }
+            std::lock_guard<std::mutex> lock{connectionsMutex};
+            openConnections.erase(connectionFd);
+            close(connectionFd);
+            if(shutdownRequested && !stopping){
+                //stop accepting and let the other clients finish their running jobs
+                stopping = true;
+                shutdown(listenFd, SHUT_RDWR);
+                for(int fd : openConnections){
+                    shutdown(fd, SHUT_RD);
+                }
+            }
+            connectionThread->finished = true;
+        });
+    }
+    for(ConnectionThread &connection : connectionThreads){
+        connection.thread.join();
+    }
+    close(listenFd);
+    unlink(path.c_str());
+    stopWorkers();
+    return true;
+}
+
+}  // namespace wildland_firesim
@@ -0,0 +1,110 @@
+#ifndef WILDLAND_FIRESIM_SERVER_H
+#define WILDLAND_FIRESIM_SERVER_H
+
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "fire.h"
+#include "globals.h"
+#include "safim.h"
+#include "WFS_landscape.h"
+#include "WFS_weatherbank.h"
+
+namespace wildland_firesim {
+
+/*!
+ * \brief The JobServer class
+ * keeps a landscape and optionally a weather trajectory bank in memory and burns the landscape for
+ * each job request, so a job costs only the fire itself. Jobs of all connections are executed by one
+ * pool of worker threads and the results are sent back as soon as a job is finished, so they can
+ * arrive in a different order than the requests.
+ *
+ * Requests and results are lines of space separated key=value pairs:
+ *   request: id=<name> [u=<vertex> v=<vertex>] [temperature=<°C>] [rh=<%>] [wind=<m/s>]
+ *            [direction=<1..8>] [trajectory=<index>] [seed=<seed>] [duration=<timesteps>]
+ *            [burnmap=<file>]
+ *   result:  id=<name> status=ok ignited=<cells> burnedOut=<cells> burning=<cells> duration=<h>
+ *            timesteps=<n> meanIntensity=<kJ/s/m> maxIntensity=<kJ/s/m> milliseconds=<ms>
+ *   error:   id=<name> status=error message=<text>
+ * Without a vertex a random vertex is ignited. Weather values not given are taken from the default
+ * weather, or the whole weather from the trajectory of the bank. The line "shutdown" stops a socket
+ * server after the running jobs.
+ */
+class JobServer
+{
+public:
+    /*!
+     * \brief JobServer
+     * \param landscape unburned landscape, its fuel is copied once
+     * \param settings timestep length and maximal fire duration of the jobs
+     * \param defaultWeather
+     * \param seed used by jobs without seed
+     */
+    JobServer(WFS_Landscape &landscape, const safim::FireSettings &settings,
+              const FireWeatherVariables &defaultWeather, unsigned int seed);
+
+    /*!
+     * \brief setWeatherBank
+     * lets jobs request the weather of a trajectory of the bank.
+     * \param bank has to outlive the server
+     * \param month
+     */
+    void setWeatherBank(const WeatherTrajectoryBank *bank, Month month);
+
+    /*!
+     * \brief serveStream
+     * reads requests from inputFd and writes results to outputFd (e.g. standard input and output)
+     * until the input ends and all jobs are finished.
+     * \param inputFd
+     * \param outputFd
+     * \param numberOfThreads
+     */
+    void serveStream(int inputFd, int outputFd, int numberOfThreads);
+
+    /*!
+     * \brief serveSocket
+     * accepts connections on a Unix domain socket until a shutdown request.
+     * \param path
+     * \param numberOfThreads
+     * \return false if the socket could not be created
+     */
+    bool serveSocket(const std::string &path, int numberOfThreads);
+
+private:
+    struct Connection;
+    struct Job {
+        std::shared_ptr<Connection> connection;
+        std::string request;
+    };
+
+    std::vector<float> m_deadBiomass;
+    std::vector<float> m_liveBiomass;
+    std::vector<std::uint8_t> m_nonFlammable;
+    FuelRasters m_fuel;
+    safim::FireSettings m_settings;
+    FireWeatherVariables m_defaultWeather;
+    unsigned int m_seed;
+    const WeatherTrajectoryBank *m_weatherBank;
+    Month m_month;
+
+    std::mutex m_mutex;
+    std::condition_variable m_jobAvailable;
+    std::condition_variable m_jobFinished;
+    std::deque<Job> m_jobs;
+    bool m_stopping;
+    std::vector<std::thread> m_workers;
+
+    void startWorkers(int numberOfThreads);
+    void stopWorkers();
+    void readRequests(const std::shared_ptr<Connection> &connection, bool *shutdownRequested);
+    void runWorker();
+    std::string runJob(const std::string &request, RasterLandscape &landscape);
+};
+
+}  // namespace wildland_firesim
+
+#endif // WILDLAND_FIRESIM_SERVER_H
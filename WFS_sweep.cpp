@@ -0,0 +1,123 @@
+#include "WFS_sweep.h"
+#include "WFS_tracing.h"
+#include <algorithm>
+#include <fstream>
+#include <memory>
+
+namespace wildland_firesim {
+
+ScenarioSweep::ScenarioSweep() : m_scenarios(), m_summaries()
+{
+
+}
+
+void
+ScenarioSweep::importScenariosFromFile(const std::string &fileName)
+{
+    auto reader = csv::Reader{',', '#'};
+    auto parameters = reader.parse(fileName);
+
+    size_t NumberOfMeteorologicalParameters = 4;
+
+    if (parameters.empty()) {
+        std::cerr << "invalid scenario table: " << fileName << " contains no scenarios\n";
+        std::exit(1);
+    }
+
+    m_scenarios.clear();
+    // the csv should have one line per scenario
+    for (const auto &line : parameters) {
+        if (line.size() != NumberOfMeteorologicalParameters) {
+            std::cerr << "invalid scenario table: there must be " << NumberOfMeteorologicalParameters
+                      << " values on each line\n";
+            std::exit(1);
+        }
+        FireWeatherVariables weather;
+        weather.temperature = utility::asFloat(line[0]);
+        weather.relHumidity = utility::asFloat(line[1]);
+        weather.windSpeed = utility::asFloat(line[2]);
+        weather.windDirection = utility::asInteger(line[3]);
+        m_scenarios.push_back(weather);
+    }
+}
+
+void
+ScenarioSweep::runScenarios(const WFS_Landscape &landscape, const Simulation &settings,
+                            unsigned int seed, TaskScheduler &scheduler)
+{
+    int numberOfScenarios = static_cast<int>(m_scenarios.size());
+    m_summaries.assign(m_scenarios.size(), ScenarioSummary());
+
+    float cellArea = static_cast<float>(landscape.getCellSize()) * landscape.getCellSize();
+
+    //every thread burns its own copy of the landscape, which is reset after each scenario
+    struct Workspace {
+        WFS_Landscape modelLandscape;
+        Simulation simulation;
+        WeatherTimeline weatherTimeline;
+        Output output;
+    };
+    std::vector<std::unique_ptr<Workspace>> workspaces(static_cast<size_t>(scheduler.getNumberOfThreads()));
+
+    scheduler.parallelFor(0, static_cast<size_t>(numberOfScenarios), 1, [&](size_t begin, size_t end) {
+        std::unique_ptr<Workspace> &workspace = workspaces[static_cast<size_t>(scheduler.getThreadIndex())];
+        if(!workspace){
+            workspace.reset(new Workspace{landscape, settings, WeatherTimeline(), Output()});
+            workspace->simulation.simulateFireWeather = false;
+        }
+        WFS_Landscape &modelLandscape = workspace->modelLandscape;
+        Simulation &simulation = workspace->simulation;
+        for(size_t i = begin; i < end; i++){
+            WILDLAND_TRACE_SPAN("scenario");
+            const FireWeatherVariables &weather = m_scenarios[i];
+            utility::RandomStream random{seed};
+            simulation.fire.setRandomStream(&random);
+            workspace->weatherTimeline.setFixedWeather(weather);
+            simulation.runSimulation(&modelLandscape, &workspace->weatherTimeline, &workspace->output);
+
+            const FireStatistics &statistics = simulation.fire.statistics;
+            ScenarioSummary &summary = m_summaries[i];
+            summary.weather = weather;
+            //cells still burning when the maximal duration is reached count as burned
+            summary.burnedCells = statistics.numberOfCellsBurnedOut + simulation.fire.numberOfCellsBurning;
+            summary.burnedArea = summary.burnedCells * cellArea / 10000.f;
+            summary.duration = simulation.durationOfFire;
+            summary.meanFirelineIntensity = statistics.numberOfCellsBurnedOut > 0 ?
+                        static_cast<float>(statistics.sumOfFirelineIntensity / statistics.numberOfCellsBurnedOut) : 0.f;
+            summary.maximumFirelineIntensity = statistics.maximumFirelineIntensity;
+
+            simulation.fire.setRandomStream(&utility::globalRandomStream());
+            modelLandscape.resetCellStates();
+        }
+    });
+}
+
+void
+ScenarioSweep::writeSummaryToCSV(const std::string &fileName) const
+{
+    std::ofstream summaryFile;
+    summaryFile.open(fileName);
+    //header
+    summaryFile << "scenario,temperature,relHumidity,windSpeed,windDirection,"
+                << "burnedCells,burnedArea,duration,meanIntensity,maxIntensity" << "\n";
+    //data
+    for(size_t i = 0; i < m_summaries.size(); i++){
+        const ScenarioSummary &summary = m_summaries[i];
+        summaryFile << i << ",";
+        summaryFile << summary.weather.temperature << "," << summary.weather.relHumidity << ",";
+        summaryFile << summary.weather.windSpeed << "," << summary.weather.windDirection << ",";
+        summaryFile << summary.burnedCells << "," << summary.burnedArea << ",";
+        summaryFile << summary.duration << ",";
+        summaryFile << summary.meanFirelineIntensity << "," << summary.maximumFirelineIntensity;
+        summaryFile << "\n";
+    }
+    summaryFile.close();
+}
+
+const std::vector<ScenarioSummary> &
+ScenarioSweep::getSummaries() const noexcept
+{
+    return m_summaries;
+}
+
+}  // namespace wildland_firesim
@@ -0,0 +1,75 @@
+#ifndef WILDLAND_FIRESIM_SWEEP_H
+#define WILDLAND_FIRESIM_SWEEP_H
+
+#include <string>
+#include <vector>
+#include "fire.h"
+#include "simulation.h"
+#include "WFS_landscape.h"
+#include "WFS_scheduler.h"
+
+namespace wildland_firesim {
+
+/*!
+ * \brief The ScenarioSummary struct
+ * holds the result of burning the landscape under one fixed fire weather scenario.
+ */
+struct ScenarioSummary {
+    FireWeatherVariables weather;
+    int burnedCells;
+    float burnedArea;
+    float duration;
+    float meanFirelineIntensity;
+    float maximumFirelineIntensity;
+};
+
+/*!
+ * \brief The ScenarioSweep class
+ * burns the same landscape and ignition under many fixed fire weather scenarios. The landscape is
+ * held in memory once and every worker thread burns a copy of it. All scenarios draw from streams
+ * with the same seed (common random numbers), so differences between scenarios are caused by the
+ * weather and not by the random draws, and results do not depend on the number of threads.
+ */
+class ScenarioSweep
+{
+public:
+    ScenarioSweep();
+
+    /*!
+     * \brief importScenariosFromFile
+     * reads the scenario table. Each line contains temperature, relative humidity, wind speed and
+     * wind direction of one scenario.
+     * \param fileName
+     */
+    void importScenariosFromFile(const std::string &fileName);
+
+    /*!
+     * \brief runScenarios
+     * burns the landscape under each scenario in parallel. Each scenario is a task of the scheduler;
+     * the fire of a scenario shares its spread with idle threads if its settings have the scheduler.
+     * \param landscape unburned landscape
+     * \param settings simulation parameters (timestep length, maximal duration, ignition)
+     * \param seed
+     * \param scheduler
+     */
+    void runScenarios(const WFS_Landscape &landscape, const Simulation &settings, unsigned int seed,
+                      TaskScheduler &scheduler);
+
+    /*!
+     * \brief writeSummaryToCSV
+     * writes one summary row per scenario. Burned area is given in ha, duration in h and
+     * intensities in kJ/s/m.
+     * \param fileName
+     */
+    void writeSummaryToCSV(const std::string &fileName) const;
+
+    const std::vector<ScenarioSummary> &getSummaries() const noexcept;
+
+private:
+    std::vector<FireWeatherVariables> m_scenarios;
+    std::vector<ScenarioSummary> m_summaries;
+};
+
+}  // namespace wildland_firesim
+
+#endif // WILDLAND_FIRESIM_SWEEP_H
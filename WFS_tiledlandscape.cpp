@@ -0,0 +1,87 @@
+#include "WFS_tiledlandscape.h"
+#include <algorithm>
+#include "utility.h"
+
+namespace wildland_firesim {
+
+TiledLandscape::TiledLandscape(const LandscapeInterface &landscape)
+    : m_width(landscape.getWidth()), m_height(landscape.getHeight()), m_cellSize(landscape.getCellSize()),
+      m_tilesPerRow((landscape.getWidth() + TileSize - 1) >> TileShift), m_tiles(), m_owned(),
+      m_numberOfOwnedTiles(0)
+{
+    int tilesPerColumn = (m_height + TileSize - 1) >> TileShift;
+    m_tiles.resize(static_cast<size_t>(m_tilesPerRow) * tilesPerColumn);
+    for(auto &tile : m_tiles){
+        tile = std::make_shared<Tile>();
+    }
+    for(int y = 0; y < m_height; y++){
+        for(int x = 0; x < m_width; x++){
+            const Cell *source = landscape.getCellInformation(x, y);
+            Cell &cell = (*m_tiles[tileIndex(x, y)])[cellIndex(x, y)];
+            cell = *source;
+            //the states are stamped with the epoch of the source, this landscape starts its own
+            cell.setState(source->getState(landscape.getStateEpoch()), getStateEpoch());
+        }
+    }
+    m_owned.assign(m_tiles.size(), 1);
+    m_numberOfOwnedTiles = static_cast<int>(m_tiles.size());
+}
+
+int
+TiledLandscape::getWidth() const noexcept
+{
+    return m_width;
+}
+
+int
+TiledLandscape::getHeight() const noexcept
+{
+    return m_height;
+}
+
+int
+TiledLandscape::getCellSize() const noexcept
+{
+    return m_cellSize;
+}
+
+Cell *
+TiledLandscape::getCellInformation(int x, int y)
+{
+    size_t tile = tileIndex(x, y);
+    if(!m_owned[tile]){
+        //copy on first access, the shared tile may be read by other forks at the same time
+        m_tiles[tile] = std::make_shared<Tile>(*m_tiles[tile]);
+        m_owned[tile] = 1;
+        m_numberOfOwnedTiles++;
+    }
+    return &(*m_tiles[tile])[cellIndex(x, y)];
+}
+
+const Cell *
+TiledLandscape::getCellInformation(int x, int y) const
+{
+    return &(*m_tiles[tileIndex(x, y)])[cellIndex(x, y)];
+}
+
+void
+TiledLandscape::share()
+{
+    std::fill(m_owned.begin(), m_owned.end(), 0);
+    m_numberOfOwnedTiles = 0;
+}
+
+TiledLandscape
+TiledLandscape::fork() const
+{
+    WILDLAND_ASSERT(m_numberOfOwnedTiles == 0, "only landscapes sharing all tiles can be forked");
+    return TiledLandscape(*this);
+}
+
+int
+TiledLandscape::getNumberOfOwnedTiles() const noexcept
+{
+    return m_numberOfOwnedTiles;
+}
+
+}  // namespace wildland_firesim
@@ -0,0 +1,87 @@
+#ifndef WILDLAND_FIRESIM_TILEDLANDSCAPE_H
+#define WILDLAND_FIRESIM_TILEDLANDSCAPE_H
+
+#include <array>
+#include <memory>
+#include <vector>
+#include "cell.h"
+#include "landscape_interface.h"
+
+namespace wildland_firesim {
+
+/*!
+ * \brief The TiledLandscape class
+ * holds the cells of a landscape in tiles of 64 x 64 cells which are shared between forks of the
+ * landscape. A fork copies a tile when the fire accesses one of its cells for the first time, so
+ * forks of a burning landscape only copy the tiles around their own fire and share the rest.
+ * Read-only access (e.g. by output) does not copy tiles.
+ */
+class TiledLandscape : public LandscapeInterface
+{
+public:
+    /*!
+     * \brief TiledLandscape
+     * copies the cells of a landscape into tiles.
+     * \param landscape
+     */
+    explicit TiledLandscape(const LandscapeInterface &landscape);
+    TiledLandscape(TiledLandscape &&) = default;
+    TiledLandscape &operator=(TiledLandscape &&) = default;
+
+    int getWidth() const noexcept override;
+    int getHeight() const noexcept override;
+    int getCellSize() const noexcept override;
+    Cell *getCellInformation(int x, int y) override;
+    const Cell *getCellInformation(int x, int y) const override;
+
+    /*!
+     * \brief share
+     * gives up the exclusive ownership of all tiles, so they can be shared with forks. Afterwards
+     * tiles are copied again before they are changed.
+     */
+    void share();
+
+    /*!
+     * \brief fork
+     * returns a landscape sharing all tiles with this one. Only landscapes sharing all their tiles
+     * (see share) can be forked; forking such a landscape, e.g. that of a snapshot, from several
+     * threads at once is safe.
+     * \return
+     */
+    TiledLandscape fork() const;
+
+    /*!
+     * \brief getNumberOfOwnedTiles
+     * \return number of tiles copied by this landscape or not shared with any other
+     */
+    int getNumberOfOwnedTiles() const noexcept;
+
+private:
+    static constexpr int TileShift = 6;
+    static constexpr int TileSize = 1 << TileShift;
+    using Tile = std::array<Cell, TileSize * TileSize>;
+
+    TiledLandscape(const TiledLandscape &) = default;
+
+    int m_width;
+    int m_height;
+    int m_cellSize;
+    int m_tilesPerRow;
+    std::vector<std::shared_ptr<Tile>> m_tiles;
+    std::vector<char> m_owned; // tile is not shared and can be changed in place
+    int m_numberOfOwnedTiles;
+
+    size_t tileIndex(int x, int y) const
+    {
+        return static_cast<size_t>(y >> TileShift) * m_tilesPerRow + (x >> TileShift);
+    }
+
+    static size_t cellIndex(int x, int y)
+    {
+        return static_cast<size_t>((y & (TileSize - 1)) << TileShift | (x & (TileSize - 1)));
+    }
+};
+
+}  // namespace wildland_firesim
+
+#endif // WILDLAND_FIRESIM_TILEDLANDSCAPE_H
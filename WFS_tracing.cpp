@@ -0,0 +1,132 @@
+#include "WFS_tracing.h"
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace wildland_firesim {
+namespace tracing {
+namespace {
+
+//events per thread, a 10000 step run needs about 70000
+constexpr size_t RingBufferCapacity = size_t(1) << 18;
+
+struct TraceEvent {
+    const char *name;
+    char phase; // 'X' span, 'C' counter
+    long long timestamp;
+    long long value; // duration of a span, value of a counter
+};
+
+/*!
+ * \brief The ThreadBuffer struct
+ * ring buffer of one thread. Only the owning thread writes, it publishes the new head after the
+ * event is stored.
+ */
+struct ThreadBuffer {
+    explicit ThreadBuffer(int id) : threadId(id), events(RingBufferCapacity), head(0) {}
+
+    int threadId;
+    std::vector<TraceEvent> events;
+    std::atomic<size_t> head;
+};
+
+std::chrono::steady_clock::time_point startTime;
+//buffers outlive their threads, so workers may finish before the trace is written
+std::mutex registryMutex;
+std::vector<std::unique_ptr<ThreadBuffer>> registry;
+thread_local ThreadBuffer *threadBuffer = nullptr;
+
+ThreadBuffer &
+currentBuffer()
+{
+    if(!threadBuffer){
+        std::lock_guard<std::mutex> lock{registryMutex};
+        registry.emplace_back(new ThreadBuffer(static_cast<int>(registry.size())));
+        threadBuffer = registry.back().get();
+    }
+    return *threadBuffer;
+}
+
+void
+record(const char *name, char phase, long long timestamp, long long value)
+{
+    ThreadBuffer &buffer = currentBuffer();
+    size_t head = buffer.head.load(std::memory_order_relaxed);
+    TraceEvent &event = buffer.events[head % RingBufferCapacity];
+    event.name = name;
+    event.phase = phase;
+    event.timestamp = timestamp;
+    event.value = value;
+    buffer.head.store(head + 1, std::memory_order_release);
+}
+
+}
+
+std::atomic<bool> tracingEnabled{false};
+
+void
+start()
+{
+    startTime = std::chrono::steady_clock::now();
+    //the starting thread is listed first
+    currentBuffer();
+    tracingEnabled.store(true, std::memory_order_relaxed);
+}
+
+long long
+now()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() -
+                                                                startTime).count();
+}
+
+void
+recordSpan(const char *name, long long begin, long long end)
+{
+    record(name, 'X', begin, end - begin);
+}
+
+void
+recordCounter(const char *name, long long value)
+{
+    record(name, 'C', now(), value);
+}
+
+void
+writeTrace(const std::string &fileName)
+{
+    std::lock_guard<std::mutex> lock{registryMutex};
+    std::ofstream traceFile;
+    traceFile.open(fileName);
+    //timestamps are given in microseconds
+    traceFile << std::fixed << std::setprecision(3);
+    traceFile << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [\n";
+    bool first = true;
+    for(const auto &buffer : registry){
+        traceFile << (first ? "" : ",\n");
+        first = false;
+        traceFile << "{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": " << buffer->threadId
+                  << ", \"args\": {\"name\": \"" << (buffer->threadId == 0 ? "main" : "worker ")
+                  << (buffer->threadId == 0 ? "" : std::to_string(buffer->threadId)) << "\"}}";
+        size_t head = buffer->head.load(std::memory_order_acquire);
+        size_t begin = head > RingBufferCapacity ? head - RingBufferCapacity : 0;
+        for(size_t i = begin; i < head; i++){
+            const TraceEvent &event = buffer->events[i % RingBufferCapacity];
+            traceFile << ",\n{\"name\": \"" << event.name << "\", \"ph\": \"" << event.phase
+                      << "\", \"pid\": 1, \"tid\": " << buffer->threadId
+                      << ", \"ts\": " << event.timestamp / 1000.0;
+            if(event.phase == 'X'){
+                traceFile << ", \"dur\": " << event.value / 1000.0 << "}";
+            } else {
+                traceFile << ", \"args\": {\"value\": " << event.value << "}}";
+            }
+        }
+    }
+    traceFile << "\n]}\n";
+    traceFile.close();
+}
+
+}  // namespace tracing
+}  // namespace wildland_firesim
@@ -0,0 +1,97 @@
+#ifndef WILDLAND_FIRESIM_TRACING_H
+#define WILDLAND_FIRESIM_TRACING_H
+
+#include <atomic>
+#include <chrono>
+#include <string>
+
+/*!
+ * Timeline tracing in the Chrome trace-event format, which is read by chrome://tracing and Perfetto.
+ * Tracing is switched on at runtime by tracing::start(); while it is off a span costs one load of a
+ * flag. Every thread records into its own ring buffer without locking, the buffers are merged when the
+ * trace is written. If a buffer overflows the oldest events of that thread are overwritten.
+ */
+#define WILDLAND_TRACE_SPAN(name) wildland_firesim::tracing::Span wildlandTraceSpan{name}
+
+namespace wildland_firesim {
+namespace tracing {
+
+extern std::atomic<bool> tracingEnabled;
+
+inline bool
+isEnabled()
+{
+    return tracingEnabled.load(std::memory_order_relaxed);
+}
+
+/*!
+ * \brief start
+ * enables tracing, timestamps are relative to this call.
+ */
+void start();
+
+/*!
+ * \brief now
+ * \return nanoseconds since the start of tracing
+ */
+long long now();
+
+/*!
+ * \brief recordSpan
+ * records a completed span of the calling thread.
+ * \param name string literal
+ * \param begin
+ * \param end
+ */
+void recordSpan(const char *name, long long begin, long long end);
+
+/*!
+ * \brief recordCounter
+ * records the value of a counter track.
+ * \param name string literal
+ * \param value
+ */
+void recordCounter(const char *name, long long value);
+
+/*!
+ * \brief writeTrace
+ * writes the events of all threads as trace-event JSON. No thread may record meanwhile.
+ * \param fileName
+ */
+void writeTrace(const std::string &fileName);
+
+inline void
+counter(const char *name, long long value)
+{
+    if(isEnabled()) recordCounter(name, value);
+}
+
+/*!
+ * \brief The Span class
+ * records the time from its construction to the end of its scope.
+ */
+class Span
+{
+public:
+    explicit Span(const char *name)
+        : m_name(name), m_begin(isEnabled() ? now() : -1)
+    {
+    }
+
+    ~Span()
+    {
+        if(m_begin >= 0) recordSpan(m_name, m_begin, now());
+    }
+
+    Span(const Span &) = delete;
+    Span &operator=(const Span &) = delete;
+
+private:
+    const char *m_name;
+    long long m_begin;
+};
+
+}  // namespace tracing
+}  // namespace wildland_firesim
+
+#endif // WILDLAND_FIRESIM_TRACING_H
@@ -0,0 +1,193 @@
+#include "WFS_weatherbank.h"
+#include "WFS_tracing.h"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <thread>
+
+namespace wildland_firesim {
+namespace {
+
+const char BankFileMagic[8] = {'S', 'A', 'F', 'I', 'M', 'W', 'T', 'B'};
+constexpr std::uint32_t BankFileVersion = 2;
+
+template<typename T>
+T
+clampedFixedPoint(float value)
+{
+    float scaled = std::round(value * 100.f);
+    scaled = std::min(std::max(scaled, static_cast<float>(std::numeric_limits<T>::min())),
+                      static_cast<float>(std::numeric_limits<T>::max()));
+    return static_cast<T>(scaled);
+}
+
+}
+
+WeatherTrajectoryBank::WeatherTrajectoryBank()
+    : m_records(), m_numberOfTrajectories(0), m_numberOfHours(0), m_seed(0), m_parameterHash(0)
+{
+    static_assert(sizeof(WeatherRecord) == 8, "weather records must be packed into 8 bytes");
+}
+
+void
+WeatherTrajectoryBank::generate(const FireWeather &weatherSimulation, int numberOfTrajectories,
+                                int numberOfHours, unsigned int seed, int numberOfThreads)
+{
+    m_numberOfTrajectories = numberOfTrajectories;
+    m_numberOfHours = numberOfHours;
+    m_seed = seed;
+    m_parameterHash = weatherSimulation.getParameterHash();
+    m_records.resize(static_cast<size_t>(NumberOfMonths) * numberOfTrajectories * numberOfHours);
+
+    int numberOfItems = NumberOfMonths * numberOfTrajectories;
+    std::atomic<int> nextItem{0};
+
+    auto worker = [&]() {
+        //every worker simulates on its own copy as the weather state changes from hour to hour
+        FireWeather weather = weatherSimulation;
+        for(int item = nextItem++; item < numberOfItems; item = nextItem++){
+            WILDLAND_TRACE_SPAN("weatherTrajectory");
+            int month = item / numberOfTrajectories;
+            utility::RandomStream random{seed, static_cast<unsigned int>(item)};
+            weather.windyConditions = true; //at start of the fire there is wind
+            weather.setStartingTime(12); //fires start at 12 o'clock
+            WeatherRecord *trajectory = &m_records[static_cast<size_t>(item) * numberOfHours];
+            for(int hour = 0; hour < numberOfHours; hour++){
+                weather.calculateFireWeather(month, hour, random);
+                trajectory[hour] = encode(weather.getFireWeatherVariables());
+            }
+        }
+    };
+
+    numberOfThreads = std::max(1, std::min(numberOfThreads, numberOfItems));
+    std::vector<std::thread> threads;
+    for(int i = 1; i < numberOfThreads; i++){
+        threads.emplace_back(worker);
+    }
+    worker();
+    for(auto &thread : threads){
+        thread.join();
+    }
+}
+
+bool
+WeatherTrajectoryBank::saveToFile(const std::string &fileName) const
+{
+    std::ofstream file{fileName, std::ios::binary};
+    if(!file){
+        return false;
+    }
+    std::int32_t numberOfTrajectories = m_numberOfTrajectories;
+    std::int32_t numberOfHours = m_numberOfHours;
+    std::uint32_t seed = m_seed;
+    std::uint64_t parameterHash = m_parameterHash;
+    file.write(BankFileMagic, sizeof(BankFileMagic));
+    file.write(reinterpret_cast<const char *>(&BankFileVersion), sizeof(BankFileVersion));
+    file.write(reinterpret_cast<const char *>(&numberOfTrajectories), sizeof(numberOfTrajectories));
+    file.write(reinterpret_cast<const char *>(&numberOfHours), sizeof(numberOfHours));
+    file.write(reinterpret_cast<const char *>(&seed), sizeof(seed));
+    file.write(reinterpret_cast<const char *>(&parameterHash), sizeof(parameterHash));
+    file.write(reinterpret_cast<const char *>(m_records.data()),
+               static_cast<std::streamsize>(m_records.size() * sizeof(WeatherRecord)));
+    return static_cast<bool>(file);
+}
+
+bool
+WeatherTrajectoryBank::loadFromFile(const std::string &fileName)
+{
+    std::ifstream file{fileName, std::ios::binary};
+    if(!file){
+        return false;
+    }
+    char magic[sizeof(BankFileMagic)];
+    std::uint32_t version = 0;
+    std::int32_t numberOfTrajectories = 0;
+    std::int32_t numberOfHours = 0;
+    std::uint32_t seed = 0;
+    std::uint64_t parameterHash = 0;
+    file.read(magic, sizeof(magic));
+    file.read(reinterpret_cast<char *>(&version), sizeof(version));
+    file.read(reinterpret_cast<char *>(&numberOfTrajectories), sizeof(numberOfTrajectories));
+    file.read(reinterpret_cast<char *>(&numberOfHours), sizeof(numberOfHours));
+    file.read(reinterpret_cast<char *>(&seed), sizeof(seed));
+    file.read(reinterpret_cast<char *>(&parameterHash), sizeof(parameterHash));
+    if(!file || std::memcmp(magic, BankFileMagic, sizeof(magic)) != 0 || version != BankFileVersion ||
+            numberOfTrajectories <= 0 || numberOfHours <= 0){
+        return false;
+    }
+    std::vector<WeatherRecord> records(static_cast<size_t>(NumberOfMonths) * numberOfTrajectories * numberOfHours);
+    file.read(reinterpret_cast<char *>(records.data()),
+              static_cast<std::streamsize>(records.size() * sizeof(WeatherRecord)));
+    if(!file){
+        return false;
+    }
+    m_records.swap(records);
+    m_numberOfTrajectories = numberOfTrajectories;
+    m_numberOfHours = numberOfHours;
+    m_seed = seed;
+    m_parameterHash = parameterHash;
+    return true;
+}
+
+void
+WeatherTrajectoryBank::getTrajectory(Month month, int trajectory,
+                                     std::vector<FireWeatherVariables> *hourlyWeather) const
+{
+    WILDLAND_ASSERT(trajectory >= 0 && trajectory < m_numberOfTrajectories, "weather trajectory out of range");
+    size_t offset = (static_cast<size_t>(month) * m_numberOfTrajectories + trajectory) * m_numberOfHours;
+    hourlyWeather->resize(static_cast<size_t>(m_numberOfHours));
+    for(int hour = 0; hour < m_numberOfHours; hour++){
+        (*hourlyWeather)[static_cast<size_t>(hour)] = decode(m_records[offset + hour]);
+    }
+}
+
+int
+WeatherTrajectoryBank::getNumberOfTrajectories() const noexcept
+{
+    return m_numberOfTrajectories;
+}
+
+int
+WeatherTrajectoryBank::getNumberOfHours() const noexcept
+{
+    return m_numberOfHours;
+}
+
+unsigned int
+WeatherTrajectoryBank::getSeed() const noexcept
+{
+    return m_seed;
+}
+
+std::uint64_t
+WeatherTrajectoryBank::getParameterHash() const noexcept
+{
+    return m_parameterHash;
+}
+
+WeatherTrajectoryBank::WeatherRecord
+WeatherTrajectoryBank::encode(const FireWeatherVariables &weather)
+{
+    WeatherRecord record;
+    record.temperature = clampedFixedPoint<std::int16_t>(weather.temperature);
+    record.relHumidity = clampedFixedPoint<std::uint16_t>(weather.relHumidity);
+    record.windSpeed = clampedFixedPoint<std::uint16_t>(weather.windSpeed);
+    record.windDirection = static_cast<std::uint8_t>(weather.windDirection);
+    record.reserved = 0;
+    return record;
+}
+
+FireWeatherVariables
+WeatherTrajectoryBank::decode(const WeatherRecord &record)
+{
+    FireWeatherVariables weather;
+    weather.temperature = record.temperature / 100.f;
+    weather.relHumidity = record.relHumidity / 100.f;
+    weather.windSpeed = record.windSpeed / 100.f;
+    weather.windDirection = record.windDirection;
+    return weather;
+}
+
+}  // namespace wildland_firesim
@@ -0,0 +1,98 @@
+#ifndef WILDLAND_FIRESIM_WEATHERBANK_H
+#define WILDLAND_FIRESIM_WEATHERBANK_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "globals.h"
+#include "fire.h"
+#include "WFS_fireweather.h"
+
+namespace wildland_firesim {
+
+/*!
+ * \brief The WeatherTrajectoryBank class
+ * holds a number of precomputed hourly fire weather trajectories per month. Ensemble runs index
+ * into the bank instead of simulating the fire weather themselves. Every trajectory is drawn from
+ * its own random stream, so the bank only depends on the seed and not on the number of threads.
+ * Banks can be saved and reloaded to reproduce a study.
+ */
+class WeatherTrajectoryBank
+{
+public:
+    WeatherTrajectoryBank();
+
+    /*!
+     * \brief generate
+     * simulates the trajectories of all months in parallel.
+     * \param weatherSimulation fire weather with imported meteorological parameters
+     * \param numberOfTrajectories trajectories per month
+     * \param numberOfHours length of each trajectory
+     * \param seed
+     * \param numberOfThreads
+     */
+    void generate(const FireWeather &weatherSimulation, int numberOfTrajectories, int numberOfHours,
+                  unsigned int seed, int numberOfThreads);
+
+    /*!
+     * \brief saveToFile
+     * writes the bank into a binary file.
+     * \param fileName
+     * \return
+     */
+    bool saveToFile(const std::string &fileName) const;
+
+    /*!
+     * \brief loadFromFile
+     * reads a bank written by saveToFile.
+     * \param fileName
+     * \return false if the file does not exist or is no weather bank
+     */
+    bool loadFromFile(const std::string &fileName);
+
+    /*!
+     * \brief getTrajectory
+     * decodes the hourly fire weather of a trajectory.
+     * \param month
+     * \param trajectory
+     * \param hourlyWeather
+     */
+    void getTrajectory(Month month, int trajectory, std::vector<FireWeatherVariables> *hourlyWeather) const;
+
+    int getNumberOfTrajectories() const noexcept;
+    int getNumberOfHours() const noexcept;
+    unsigned int getSeed() const noexcept;
+
+    /*!
+     * \brief getParameterHash
+     * \return hash of the meteorological parameters the bank was simulated with, see
+     * FireWeather::getParameterHash
+     */
+    std::uint64_t getParameterHash() const noexcept;
+
+private:
+    /*!
+     * \brief The WeatherRecord struct
+     * stores the fire weather of one hour in fixed point (hundredths of the respective unit).
+     */
+    struct WeatherRecord {
+        std::int16_t temperature;
+        std::uint16_t relHumidity;
+        std::uint16_t windSpeed;
+        std::uint8_t windDirection;
+        std::uint8_t reserved;
+    };
+
+    static WeatherRecord encode(const FireWeatherVariables &weather);
+    static FireWeatherVariables decode(const WeatherRecord &record);
+
+    std::vector<WeatherRecord> m_records;
+    int m_numberOfTrajectories;
+    int m_numberOfHours;
+    unsigned int m_seed;
+    std::uint64_t m_parameterHash;
+};
+
+}  // namespace wildland_firesim
+
+#endif // WILDLAND_FIRESIM_WEATHERBANK_H
@@ -0,0 +1,113 @@
+#include "WFS_weathertimeline.h"
+
+namespace wildland_firesim {
+
+WeatherTimeline::WeatherTimeline()
+    : m_hourlyWeather(), m_weatherSimulation(nullptr), m_month(Month::January)
+{
+
+}
+
+void
+WeatherTimeline::setFixedWeather(const FireWeatherVariables &weather)
+{
+    m_weatherSimulation = nullptr;
+    m_hourlyWeather.assign(1, weather);
+}
+
+void
+WeatherTimeline::setWeatherSeries(const std::vector<FireWeatherVariables> &hourlyWeather)
+{
+    WILDLAND_ASSERT(!hourlyWeather.empty(), "weather series is empty");
+    m_weatherSimulation = nullptr;
+    m_hourlyWeather = hourlyWeather;
+}
+
+void
+WeatherTimeline::importWeatherSeriesFromFile(const std::string &fileName)
+{
+    auto reader = csv::Reader{',', '#'};
+    auto parameters = reader.parse(fileName);
+
+    size_t NumberOfMeteorologicalParameters = 4;
+
+    if (parameters.empty()) {
+        std::cerr << "invalid weather series: " << fileName << " contains no hourly weather\n";
+        std::exit(1);
+    }
+
+    m_weatherSimulation = nullptr;
+    m_hourlyWeather.clear();
+    m_hourlyWeather.reserve(parameters.size());
+    // the csv should have one line per hour
+    for (const auto &line : parameters) {
+        if (line.size() != NumberOfMeteorologicalParameters) {
+            std::cerr << "invalid weather series: there must be " << NumberOfMeteorologicalParameters
+                      << " values on each line\n";
+            std::exit(1);
+        }
+        FireWeatherVariables weather;
+        weather.temperature = utility::asFloat(line[0]);
+        weather.relHumidity = utility::asFloat(line[1]);
+        weather.windSpeed = utility::asFloat(line[2]);
+        weather.windDirection = utility::asInteger(line[3]);
+        m_hourlyWeather.push_back(weather);
+    }
+}
+
+void
+WeatherTimeline::setWeatherSimulation(FireWeather *weatherSimulation, Month month)
+{
+    m_weatherSimulation = weatherSimulation;
+    m_month = month;
+    m_hourlyWeather.clear();
+}
+
+void
+WeatherTimeline::setWeatherTrajectory(const WeatherTrajectoryBank &bank, Month month, int trajectory)
+{
+    m_weatherSimulation = nullptr;
+    bank.getTrajectory(month, trajectory, &m_hourlyWeather);
+}
+
+void
+WeatherTimeline::reset()
+{
+    if(m_weatherSimulation){
+        m_hourlyWeather.clear();
+        m_weatherSimulation->windyConditions = true; //at start of the fire there is wind
+        m_weatherSimulation->setStartingTime(12); //fires start at 12 o'clock
+    }
+}
+
+const FireWeatherVariables &
+WeatherTimeline::getWeather(int epoch)
+{
+    if(m_weatherSimulation){
+        //hours are simulated in sequence as the weather of an hour depends on the previous one
+        while(m_hourlyWeather.size() <= static_cast<size_t>(epoch)){
+            m_weatherSimulation->calculateFireWeather(m_month, static_cast<int>(m_hourlyWeather.size()));
+            m_hourlyWeather.push_back(m_weatherSimulation->getFireWeatherVariables());
+        }
+        return m_hourlyWeather[static_cast<size_t>(epoch)];
+    }
+    WILDLAND_ASSERT(!m_hourlyWeather.empty(), "weather timeline is not initialized");
+    if(static_cast<size_t>(epoch) >= m_hourlyWeather.size()){
+        return m_hourlyWeather.back();
+    }
+    return m_hourlyWeather[static_cast<size_t>(epoch)];
+}
+
+int
+WeatherTimeline::getEpoch(float durationOfBurn)
+{
+    return static_cast<int>(std::floor(durationOfBurn));
+}
+
+bool
+WeatherTimeline::isSimulated() const noexcept
+{
+    return m_weatherSimulation != nullptr;
+}
+
+}  // namespace wildland_firesim
@@ -0,0 +1,97 @@
+#ifndef WILDLAND_FIRESIM_WEATHERTIMELINE_H
+#define WILDLAND_FIRESIM_WEATHERTIMELINE_H
+
+#include <string>
+#include <vector>
+#include "fire.h"
+#include "WFS_fireweather.h"
+#include "WFS_weatherbank.h"
+
+namespace wildland_firesim {
+
+/*!
+ * \brief The WeatherTimeline class
+ * provides the hourly fire weather over the duration of a fire. Each hour is a weather epoch. The
+ * weather of an epoch is either fixed, read from an hourly weather series, taken from a weather
+ * trajectory bank or simulated by FireWeather. Simulated hours are generated once when they are
+ * first reached and kept, so every epoch is accessed in constant time.
+ */
+class WeatherTimeline
+{
+    friend class Checkpoint;
+
+public:
+    WeatherTimeline();
+
+    /*!
+     * \brief setFixedWeather
+     * uses the same fire weather for every epoch.
+     * \param weather
+     */
+    void setFixedWeather(const FireWeatherVariables &weather);
+
+    /*!
+     * \brief setWeatherSeries
+     * uses the given hourly fire weather, the last hour is kept until the end of the fire.
+     * \param hourlyWeather
+     */
+    void setWeatherSeries(const std::vector<FireWeatherVariables> &hourlyWeather);
+
+    /*!
+     * \brief importWeatherSeriesFromFile
+     * reads an hourly weather series from file. Each line contains temperature, relative humidity,
+     * wind speed and wind direction of one hour. The last hour is kept if the fire outlasts the series.
+     * \param fileName
+     */
+    void importWeatherSeriesFromFile(const std::string &fileName);
+
+    /*!
+     * \brief setWeatherSimulation
+     * simulates the fire weather of each epoch for the given month.
+     * \param weatherSimulation
+     * \param month
+     */
+    void setWeatherSimulation(FireWeather *weatherSimulation, Month month);
+
+    /*!
+     * \brief setWeatherTrajectory
+     * uses a precomputed trajectory of a weather bank instead of simulating the fire weather.
+     * \param bank
+     * \param month
+     * \param trajectory
+     */
+    void setWeatherTrajectory(const WeatherTrajectoryBank &bank, Month month, int trajectory);
+
+    /*!
+     * \brief reset
+     * prepares the timeline for a new fire. Simulated weather is discarded and generated anew.
+     */
+    void reset();
+
+    /*!
+     * \brief getWeather
+     * returns the fire weather of an epoch.
+     * \param epoch hours since ignition
+     * \return
+     */
+    const FireWeatherVariables &getWeather(int epoch);
+
+    /*!
+     * \brief getEpoch
+     * returns the epoch of a point in time of the fire.
+     * \param durationOfBurn hours since ignition
+     * \return
+     */
+    static int getEpoch(float durationOfBurn);
+
+    bool isSimulated() const noexcept;
+
+private:
+    std::vector<FireWeatherVariables> m_hourlyWeather;
+    FireWeather *m_weatherSimulation;
+    Month m_month;
+};
+
+}  // namespace wildland_firesim
+
+#endif // WILDLAND_FIRESIM_WEATHERTIMELINE_H
@@ -0,0 +1,420 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+
+#include "fire.h"
+#include "WFS_landscape.h"
+#include "WFS_output.h"
+
+/*! \file
+ * Microbenchmarks of the hot paths of the fire engine on synthetic landscapes. Every benchmark
+ * processes a known number of cells (or calls, point fire sources, records) per repetition; the
+ * median over all repetitions is reported in ns/cell and cells/s as JSON, so results of different
+ * releases can be compared.
+ */
+
+using namespace ::wildland_firesim;
+
+static const char *progname = nullptr;
+static const char *resultFile = nullptr;
+
+static int landscapeSize = 1000;
+static int repetitions = 5;
+static int numberOfThreads = static_cast<int>(std::thread::hardware_concurrency());
+
+namespace wildland_firesim {
+
+/*!
+ * \brief The FireBenchmark class
+ * gives the benchmarks access to the individual phases of the spread kernel.
+ */
+class FireBenchmark
+{
+public:
+    static float directionalRateOfSpread(Fire &fire, float windSpeed, int windDirection,
+                                         float headFireRateOfSpread, int direction)
+    {
+        return fire.calculateDirectionalRateOfSpread(windSpeed, windDirection, headFireRateOfSpread, direction);
+    }
+
+    /*!
+     * \brief setFront
+     * lets the given cells burn from the lower left vertex without any progress.
+     */
+    static void setFront(Fire &fire, LandscapeInterface *landscape, const std::vector<std::pair<int, int>> &cells)
+    {
+        int direction[CellInternSpreadDirectionsCount] = {1, 2, 3};
+        fire.resetFire();
+        for(const auto &coordinates : cells){
+            Fire::burningCellInformation burningCell;
+            burningCell.xCoord = coordinates.first;
+            burningCell.yCoord = coordinates.second;
+            burningCell.uCoordSource = coordinates.first;
+            burningCell.vCoordSource = coordinates.second;
+            burningCell.meanFirelineIntensity = 0.f;
+            burningCell.weatherEpoch = fire.m_weatherEpoch - 1;
+            for(int k = 0; k < CellInternSpreadDirectionsCount; k++){
+                burningCell.spreadDirection[k] = direction[k];
+                burningCell.burnStatus[k] = 0.f;
+            }
+            landscape->getCellInformation(coordinates.first, coordinates.second)->setState(CellState::Burning,
+                                                                                           landscape->getStateEpoch());
+            fire.burningCellInformationVector.push_back(burningCell);
+            fire.numberOfCellsBurning++;
+        }
+    }
+
+    /*!
+     * \brief setPointFireSources
+     * places point fire sources of high intensity on the given vertices.
+     */
+    static void setPointFireSources(Fire &fire, LandscapeInterface *landscape,
+                                    const std::vector<std::pair<int, int>> &vertices)
+    {
+        fire.distance_to_cell_boundary[0] = static_cast<float>(landscape->getCellSize());
+        fire.distance_to_cell_boundary[1] = std::sqrt(2.f) * landscape->getCellSize();
+        fire.distance_to_cell_boundary[2] = static_cast<float>(landscape->getCellSize());
+        fire.m_spreadArena.reset();
+        fire.pointFireSources = fire.m_spreadArena.allocate<Fire::pointFireSourceInformation>(vertices.size());
+        fire.numberOfPointFireSources = 0;
+        for(const auto &coordinates : vertices){
+            Fire::pointFireSourceInformation pointFireSource;
+            pointFireSource.uCoord = coordinates.first;
+            pointFireSource.vCoord = coordinates.second;
+            pointFireSource.remainingTime = 0;
+            pointFireSource.fireIntensity = 5000.f;
+            fire.pointFireSources[fire.numberOfPointFireSources++] = pointFireSource;
+        }
+    }
+
+    static void igniteCells(Fire &fire, LandscapeInterface *landscape)
+    {
+        fire.igniteCells(landscape);
+    }
+};
+
+}  // namespace wildland_firesim
+
+namespace {
+
+struct BenchmarkResult {
+    std::string name;
+    long long cells;
+    double medianNanoseconds;
+    double minimumNanoseconds;
+};
+
+std::vector<BenchmarkResult> results;
+
+/*!
+ * \brief runBenchmark
+ * times repetitions of a benchmark after one warm-up run. The setup is not timed.
+ */
+void
+runBenchmark(const std::string &name, long long cells, const std::function<void()> &setup,
+             const std::function<void()> &benchmark)
+{
+    std::vector<double> durations;
+    for(int r = 0; r <= repetitions; r++){
+        setup();
+        auto start = std::chrono::steady_clock::now();
+        benchmark();
+        auto end = std::chrono::steady_clock::now();
+        //the first run warms up caches and the allocator
+        if(r > 0){
+            durations.push_back(std::chrono::duration<double, std::nano>(end - start).count());
+        }
+    }
+    std::sort(durations.begin(), durations.end());
+    BenchmarkResult result;
+    result.name = name;
+    result.cells = cells;
+    result.medianNanoseconds = durations[durations.size() / 2];
+    result.minimumNanoseconds = durations.front();
+    results.push_back(result);
+    fprintf(stderr, "%-48s %12.2f ns/cell %14.0f cells/s\n", name.c_str(),
+            result.medianNanoseconds / cells, cells / (result.medianNanoseconds * 1e-9));
+}
+
+void
+writeParameterFile(const std::string &fileName, int size, float percentageGrass)
+{
+    std::ofstream file{fileName};
+    file << size << "\n" << size << "\n" << 30 << "\n" << percentageGrass << "\n"
+         << 1.f - percentageGrass << "\n" << 360 << "\n" << 0.7 << "\n" << 0 << "\n" << 0.6 << "\n" << 9 << "\n";
+}
+
+void
+writeASCIIgrid(const std::string &fileName, int size, const std::function<float(int, int)> &value)
+{
+    std::ofstream file{fileName};
+    file << "NCOLS " << size << "\n" << "NROWS " << size << "\n" << "XLLCORNER 0\n" << "YLLCORNER 0\n"
+         << "CELLSIZE 1\n" << "NODATA_VALUE -9999\n";
+    for(int y = 0; y < size; y++){
+        for(int x = 0; x < size; x++){
+            file << value(x, y) << " ";
+        }
+        file << "\n";
+    }
+}
+
+void
+writeResults(FILE *file)
+{
+    fprintf(file, "{\n  \"landscape_size\": %d,\n  \"repetitions\": %d,\n  \"threads\": %d,\n",
+            landscapeSize, repetitions, numberOfThreads);
+    fprintf(file, "  \"benchmarks\": [\n");
+    for(size_t i = 0; i < results.size(); i++){
+        const BenchmarkResult &result = results[i];
+        fprintf(file, "    {\"name\": \"%s\", \"cells\": %lld, \"ns_per_cell\": %.4f, "
+                      "\"min_ns_per_cell\": %.4f, \"cells_per_second\": %.1f}%s\n",
+                result.name.c_str(), result.cells, result.medianNanoseconds / result.cells,
+                result.minimumNanoseconds / result.cells, result.cells / (result.medianNanoseconds * 1e-9),
+                i + 1 < results.size() ? "," : "");
+    }
+    fprintf(file, "  ]\n}\n");
+}
+
+[[noreturn]] void
+usage()
+{
+    fprintf(stderr, "usage: %s OPTIONS\n", progname);
+    fprintf(stderr, "Wildland Fire Simulator benchmarks\n\nOptions:\n");
+    fprintf(stderr, "\t-h\tDisplays this help.\n");
+    fprintf(stderr, "\t-s <size>\tWidth and height of the synthetic landscapes in cells.\n");
+    fprintf(stderr, "\t-r <repetitions>\tTimed repetitions per benchmark.\n");
+    fprintf(stderr, "\t-j <number-of-threads>\tThreads for landscape generation.\n");
+    fprintf(stderr, "\t-o <result-file>\tJSON file for the results (default: standard output).\n");
+    exit(1);
+}
+
+void
+parseArguments(int argc, char *argv[])
+{
+    progname = argv[0];
+
+    while (argc > 1 && argv[1][0] == '-') {
+        if (argc < 3 && argv[1][1] != 'h')
+            usage();
+        switch (argv[1][1]) {
+        case 'h':
+        default:
+            usage();
+        case 's':
+            landscapeSize = atoi(argv[2]);
+            break;
+        case 'r':
+            repetitions = atoi(argv[2]);
+            break;
+        case 'j':
+            numberOfThreads = atoi(argv[2]);
+            break;
+        case 'o':
+            resultFile = argv[2];
+            break;
+        }
+        argc -= 2;
+        argv += 2;
+    }
+    if (landscapeSize < 4 || repetitions < 1)
+        usage();
+    numberOfThreads = std::max(1, numberOfThreads);
+}
+
+}
+
+int main(int argc, char *argv[])
+{
+    parseArguments(argc, argv);
+
+    FILE *output = stdout;
+    if (resultFile) {
+        output = fopen(resultFile, "w");
+        if (!output) {
+            fprintf(stderr, "error: cannot write %s\n", resultFile);
+            return 1;
+        }
+    }
+
+    //all files are written into a temporary working directory
+    char directory[] = "/tmp/wildland-bench-XXXXXX";
+    if (!mkdtemp(directory) || chdir(directory) != 0) {
+        fprintf(stderr, "error: cannot create temporary directory\n");
+        return 1;
+    }
+
+    long long numberOfCells = static_cast<long long>(landscapeSize) * landscapeSize;
+
+    FireWeatherVariables weather;
+    weather.temperature = 30.f;
+    weather.relHumidity = 15.f;
+    weather.windSpeed = 3.5f;
+    weather.windDirection = 1;
+
+    //landscape generation
+    writeParameterFile("grass.txt", landscapeSize, 1.f);
+    writeParameterFile("clusters.txt", landscapeSize, 0.7f);
+    {
+        WFS_Landscape landscape;
+        runBenchmark("generateLandscapeFromFile/grass", numberOfCells, [](){},
+                     [&]() { landscape.generateLandscapeFromFile("grass.txt", 42, numberOfThreads); });
+        runBenchmark("generateLandscapeFromFile/clusters", numberOfCells, [](){},
+                     [&]() { landscape.generateLandscapeFromFile("clusters.txt", 42, numberOfThreads); });
+    }
+
+    //landscape import
+    writeASCIIgrid("GroundCover.asc", landscapeSize, [](int x, int y) { return (x / 7 + y / 5) % 9 == 0 ? 5.f : 2.f; });
+    writeASCIIgrid("dead-biomass.asc", landscapeSize, [](int, int) { return 252.f; });
+    writeASCIIgrid("live-biomass.asc", landscapeSize, [](int, int) { return 108.f; });
+    {
+        WFS_Landscape landscape;
+        runBenchmark("importLandscapeFromFile", numberOfCells, [](){},
+                     [&]() { landscape.importLandscapeFromFile(); });
+    }
+
+    WFS_Landscape landscape;
+    landscape.generateLandscapeFromFile("grass.txt", 42, numberOfThreads);
+    Fire fire;
+    fire.setFireWeather(weather);
+
+    //rate of spread equation
+    {
+        volatile float sink = 0.f;
+        runBenchmark("calculateDirectionalRateOfSpread", numberOfCells, [](){}, [&]() {
+            float sum = 0.f;
+            for(long long i = 0; i < numberOfCells; i++){
+                sum += FireBenchmark::directionalRateOfSpread(fire, 0.5f + (i & 7), static_cast<int>(i & 7),
+                                                              0.3f, static_cast<int>(i % 8) + 1);
+            }
+            sink = sum;
+        });
+        (void)sink;
+    }
+
+    //spread kernel at fixed front sizes. A timestep length of zero keeps the burn status and
+    //therefore the front constant.
+    std::vector<long long> frontSizes{100, 1000, 10000, 100000};
+    for(long long frontSize : frontSizes){
+        if(frontSize > numberOfCells / 4) break;
+        std::vector<std::pair<int, int>> cells;
+        for(long long i = 0; i < frontSize; i++){
+            //cells on every second row and column, so fronts are spread over the landscape
+            long long position = i * 2;
+            int x = static_cast<int>(position % landscapeSize);
+            int y = static_cast<int>((position / landscapeSize) * 2);
+            cells.push_back(std::make_pair(x, y));
+        }
+        FireBenchmark::setFront(fire, &landscape, cells);
+        runBenchmark("spreadFire/front=" + std::to_string(frontSize), frontSize, [](){},
+                     [&]() { fire.spreadFire(&landscape, 0); });
+        runBenchmark("spreadFire/newWeatherEpoch/front=" + std::to_string(frontSize), frontSize,
+                     [&]() { fire.setFireWeather(weather); },
+                     [&]() { fire.spreadFire(&landscape, 0); });
+        FireBenchmark::setFront(fire, &landscape, std::vector<std::pair<int, int>>());
+        landscape.resetCellStates();
+
+        //ignition of the four cells around each point fire source
+        std::vector<std::pair<int, int>> vertices;
+        for(const auto &coordinates : cells){
+            vertices.push_back(std::make_pair(coordinates.first + 1, coordinates.second + 1));
+        }
+        runBenchmark("igniteCells/pointFireSources=" + std::to_string(frontSize), frontSize, [&]() {
+            landscape.resetCellStates();
+            FireBenchmark::setFront(fire, &landscape, std::vector<std::pair<int, int>>());
+            FireBenchmark::setPointFireSources(fire, &landscape, vertices);
+        }, [&]() { FireBenchmark::igniteCells(fire, &landscape); });
+        landscape.resetCellStates();
+        FireBenchmark::setFront(fire, &landscape, std::vector<std::pair<int, int>>());
+    }
+
+    //ignition around a ring-shaped front like that of a fire, visited along the ring or sorted by
+    //the storage index of the cells like a sorted front, in both cell layouts
+    {
+        WFS_Landscape zOrderLandscape;
+        zOrderLandscape.setLayout(CellLayout::ZOrderTiles);
+        zOrderLandscape.generateLandscapeFromFile("grass.txt", 42, numberOfThreads);
+        for(long long frontSize : frontSizes){
+            if(frontSize > numberOfCells / 16) break;
+            //concentric rings of vertices two cells apart, each ring in the order of its angles
+            std::vector<std::pair<int, int>> vertices;
+            int center = landscapeSize / 2;
+            for(int radius = center - 2; radius >= 2 && static_cast<long long>(vertices.size()) < frontSize; radius -= 2){
+                int verticesOnRing = static_cast<int>(Pi * radius);
+                for(int k = 0; k < verticesOnRing && static_cast<long long>(vertices.size()) < frontSize; k++){
+                    float angle = 2.f * Pi * k / verticesOnRing;
+                    vertices.push_back(std::make_pair(center + static_cast<int>(std::round(radius * std::cos(angle))),
+                                                      center + static_cast<int>(std::round(radius * std::sin(angle)))));
+                }
+            }
+            auto layouts = {std::make_pair(std::string("rowMajor"), &landscape),
+                            std::make_pair(std::string("zOrder"), &zOrderLandscape)};
+            for(const auto &layout : layouts){
+                WFS_Landscape *layoutLandscape = layout.second;
+                std::vector<std::pair<int, int>> sortedVertices = vertices;
+                std::sort(sortedVertices.begin(), sortedVertices.end(),
+                          [&](const std::pair<int, int> &a, const std::pair<int, int> &b) {
+                    return layoutLandscape->getCellIndex(a.first, a.second) <
+                            layoutLandscape->getCellIndex(b.first, b.second);
+                });
+                for(const auto *front : {&vertices, &sortedVertices}){
+                    runBenchmark("igniteCells/ring/" + layout.first + (front == &vertices ? "" : "/sorted") +
+                                 "/pointFireSources=" + std::to_string(vertices.size()),
+                                 static_cast<long long>(vertices.size()), [&]() {
+                        layoutLandscape->resetCellStates();
+                        FireBenchmark::setFront(fire, layoutLandscape, std::vector<std::pair<int, int>>());
+                        FireBenchmark::setPointFireSources(fire, layoutLandscape, *front);
+                    }, [&]() { FireBenchmark::igniteCells(fire, layoutLandscape); });
+                }
+                layoutLandscape->resetCellStates();
+                FireBenchmark::setFront(fire, layoutLandscape, std::vector<std::pair<int, int>>());
+            }
+        }
+    }
+
+    //output writers, with a burning front of 100 cells
+    {
+        std::vector<std::pair<int, int>> cells;
+        for(int i = 0; i < 100; i++){
+            cells.push_back(std::make_pair((i * 7) % landscapeSize, (i * 13) % landscapeSize));
+        }
+        FireBenchmark::setFront(fire, &landscape, cells);
+        fire.spreadFire(&landscape, 0);
+        Output output;
+        runBenchmark("writeBurnMapToASCII", numberOfCells, [](){},
+                     [&]() { output.writeBurnMapToASCII(landscape, "burn_map.asc"); });
+        runBenchmark("writeVegetationMapToASCII", numberOfCells, [](){},
+                     [&]() { output.writeVegetationMapToASCII(landscape, "vegetation_map.asc"); });
+        runBenchmark("writeVegetationDataToCSV", numberOfCells, [](){},
+                     [&]() { output.writeVegetationDataToCSV(landscape, "vegetation_data.csv"); });
+        runBenchmark("writeBurnDataToCSV", numberOfCells, [](){},
+                     [&]() { output.writeBurnDataToCSV(landscape, fire, "burndata.csv"); });
+        std::vector<std::string> weatherData;
+        for(int hour = 0; hour < 10000; hour++){
+            weatherData.push_back(output.storeWeatherData(weather, static_cast<float>(hour)));
+        }
+        runBenchmark("writeFireWeatherDataToCSV", static_cast<long long>(weatherData.size()), [](){},
+                     [&]() { output.writeFireWeatherDataToCSV(weatherData, "weatherdata.csv"); });
+    }
+
+    writeResults(output);
+    if (output != stdout)
+        fclose(output);
+
+    //remove the temporary files
+    const char *files[] = {"grass.txt", "clusters.txt", "GroundCover.asc", "dead-biomass.asc",
+                           "live-biomass.asc", "burn_map.asc", "vegetation_map.asc",
+                           "vegetation_data.csv", "burndata.csv", "weatherdata.csv"};
+    for (const char *file : files)
+        unlink(file);
+    if (chdir("/") == 0)
+        rmdir(directory);
+
+    return 0;
+}
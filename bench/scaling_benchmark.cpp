@@ -0,0 +1,388 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <dirent.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+/*! \file
+ * Scaling study driver. It runs the complete WildlandFireSimulator pipeline (landscape generation,
+ * fire, output) as a separate process for each combination of landscape size, thread count and
+ * wind regime and records wall time, peak resident set size, burned cells per second and output
+ * bytes. Results can be compared against a stored baseline; exceeding the regression thresholds
+ * makes the driver fail, so performance work can be proven.
+ */
+
+static const char *progname = nullptr;
+static const char *simulator = "./WildlandFireSimulator";
+static const char *resultFile = nullptr;
+static const char *baselineFile = nullptr;
+
+static std::vector<int> landscapeSizes{100, 1000, 5000, 10000, 20000};
+static std::vector<int> threadCounts;
+static int maximalFireDuration = 1000;
+static int repetitions = 3;
+static double timeThreshold = 0.10;
+static double memoryThreshold = 0.10;
+
+namespace {
+
+/*!
+ * \brief The WindRegime struct
+ * fixed fire weather in the format of the "fixed_*Wind.txt" files.
+ */
+struct WindRegime {
+    const char *name;
+    float temperature;
+    float relHumidity;
+    float windSpeed;
+    int windDirection;
+};
+
+const WindRegime windRegimes[] = {
+    {"calm", 30.f, 15.f, 0.f, 0},
+    {"strong", 30.f, 15.f, 8.f, 1},
+};
+
+struct RunResult {
+    int size;
+    int threads;
+    std::string wind;
+    double wallSeconds;
+    long peakResidentSetKilobytes;
+    long long cellsBurned;
+    long long outputBytes;
+};
+
+std::vector<int>
+parseList(const char *list)
+{
+    std::vector<int> values;
+    std::stringstream ss{list};
+    std::string value;
+    while(std::getline(ss, value, ',')){
+        if(!value.empty()) values.push_back(atoi(value.c_str()));
+    }
+    return values;
+}
+
+/*!
+ * \brief countBurnedCells
+ * counts burning and burned-out cells of a burn map written by the simulator.
+ */
+long long
+countBurnedCells(const std::string &fileName)
+{
+    std::ifstream file{fileName};
+    std::string line;
+    for(int i = 0; i < 6; i++){
+        std::getline(file, line);
+    }
+    long long burned = 0;
+    int state;
+    while(file >> state){
+        if(state != 0) burned++;
+    }
+    return burned;
+}
+
+/*!
+ * \brief outputBytes
+ * sums the sizes of all files in a run directory except the inputs.
+ */
+long long
+outputBytes(const std::string &directory)
+{
+    long long bytes = 0;
+    DIR *dir = opendir(directory.c_str());
+    if(!dir) return 0;
+    while(struct dirent *entry = readdir(dir)){
+        std::string name = entry->d_name;
+        if(name == "." || name == ".." || name == "landscape.txt" || name == "weather.txt") continue;
+        struct stat status;
+        if(stat((directory + "/" + name).c_str(), &status) == 0) bytes += status.st_size;
+    }
+    closedir(dir);
+    return bytes;
+}
+
+void
+removeDirectory(const std::string &directory)
+{
+    DIR *dir = opendir(directory.c_str());
+    if(!dir) return;
+    while(struct dirent *entry = readdir(dir)){
+        std::string name = entry->d_name;
+        if(name == "." || name == "..") continue;
+        unlink((directory + "/" + name).c_str());
+    }
+    closedir(dir);
+    rmdir(directory.c_str());
+}
+
+/*!
+ * \brief runSimulator
+ * runs one configuration in a fresh temporary directory.
+ */
+RunResult
+runSimulator(const std::string &simulatorPath, int size, int threads, const WindRegime &wind)
+{
+    char directory[] = "/tmp/wildland-scaling-XXXXXX";
+    if(!mkdtemp(directory)){
+        fprintf(stderr, "error: cannot create temporary directory\n");
+        exit(1);
+    }
+    {
+        //landscape parameter file: grass with some non-flammable clusters
+        std::ofstream landscape{std::string(directory) + "/landscape.txt"};
+        landscape << size << "\n" << size << "\n30\n0.9\n0.1\n360\n0.7\n0\n0.6\n9\n";
+        std::ofstream weather{std::string(directory) + "/weather.txt"};
+        weather << wind.temperature << "\n" << wind.relHumidity << "\n" << wind.windSpeed << "\n"
+                << wind.windDirection << "\n";
+    }
+
+    std::string duration = std::to_string(maximalFireDuration);
+    std::string threadCount = std::to_string(threads);
+    auto start = std::chrono::steady_clock::now();
+    pid_t pid = fork();
+    if(pid == 0){
+        if(chdir(directory) != 0) _exit(127);
+        //the simulator reports its settings on standard output
+        if(!freopen("/dev/null", "w", stdout)) _exit(127);
+        execl(simulatorPath.c_str(), simulatorPath.c_str(), "-l", "landscape.txt", "-b", "weather.txt",
+              "-c", "-r", "1", "-g", "42", "-d", duration.c_str(), "-j", threadCount.c_str(),
+              static_cast<char *>(nullptr));
+        _exit(127);
+    }
+    int status = 0;
+    struct rusage usage;
+    if(pid < 0 || wait4(pid, &status, 0, &usage) != pid || !WIFEXITED(status) || WEXITSTATUS(status) != 0){
+        fprintf(stderr, "error: %s failed for size %d, %d threads, %s wind\n", simulatorPath.c_str(),
+                size, threads, wind.name);
+        exit(1);
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    RunResult result;
+    result.size = size;
+    result.threads = threads;
+    result.wind = wind.name;
+    result.wallSeconds = std::chrono::duration<double>(end - start).count();
+    result.peakResidentSetKilobytes = usage.ru_maxrss;
+    result.cellsBurned = countBurnedCells(std::string(directory) + "/burn_map0.asc");
+    result.outputBytes = outputBytes(directory);
+    removeDirectory(directory);
+    return result;
+}
+
+void
+writeResult(FILE *file, const RunResult &result, bool last)
+{
+    fprintf(file, "    {\"size\": %d, \"threads\": %d, \"wind\": \"%s\", \"wall_seconds\": %.6f, "
+                  "\"peak_rss_kb\": %ld, \"cells_burned\": %lld, \"cells_burned_per_second\": %.1f, "
+                  "\"output_bytes\": %lld}%s\n",
+            result.size, result.threads, result.wind.c_str(), result.wallSeconds,
+            result.peakResidentSetKilobytes, result.cellsBurned,
+            result.cellsBurned / std::max(result.wallSeconds, 1e-9), result.outputBytes, last ? "" : ",");
+}
+
+/*!
+ * \brief readBaseline
+ * reads the runs of a result file written by this driver (one run per line).
+ */
+std::vector<RunResult>
+readBaseline(const char *fileName)
+{
+    std::vector<RunResult> baseline;
+    std::ifstream file{fileName};
+    if(!file){
+        fprintf(stderr, "error: cannot read baseline %s\n", fileName);
+        exit(1);
+    }
+    std::string line;
+    while(std::getline(file, line)){
+        RunResult result;
+        char wind[16];
+        double cellsPerSecond;
+        if(sscanf(line.c_str(), " {\"size\": %d, \"threads\": %d, \"wind\": \"%15[^\"]\", \"wall_seconds\": %lf, "
+                                "\"peak_rss_kb\": %ld, \"cells_burned\": %lld, \"cells_burned_per_second\": %lf, "
+                                "\"output_bytes\": %lld",
+                  &result.size, &result.threads, wind, &result.wallSeconds, &result.peakResidentSetKilobytes,
+                  &result.cellsBurned, &cellsPerSecond, &result.outputBytes) == 8){
+            result.wind = wind;
+            baseline.push_back(result);
+        }
+    }
+    return baseline;
+}
+
+/*!
+ * \brief compareWithBaseline
+ * reports runs slower or larger than the baseline beyond the thresholds.
+ * \return number of regressions
+ */
+int
+compareWithBaseline(const std::vector<RunResult> &results, const std::vector<RunResult> &baseline)
+{
+    int regressions = 0;
+    fprintf(stderr, "\n%8s %8s %8s %12s %12s %12s %12s\n", "size", "threads", "wind", "time", "baseline",
+            "rss [kB]", "baseline");
+    for(const RunResult &result : results){
+        for(const RunResult &reference : baseline){
+            if(reference.size != result.size || reference.threads != result.threads ||
+                    reference.wind != result.wind) continue;
+            bool slower = result.wallSeconds > reference.wallSeconds * (1.0 + timeThreshold);
+            bool larger = result.peakResidentSetKilobytes >
+                    reference.peakResidentSetKilobytes * (1.0 + memoryThreshold);
+            fprintf(stderr, "%8d %8d %8s %12.4f %12.4f %12ld %12ld%s%s\n", result.size, result.threads,
+                    result.wind.c_str(), result.wallSeconds, reference.wallSeconds,
+                    result.peakResidentSetKilobytes, reference.peakResidentSetKilobytes,
+                    slower ? "  TIME REGRESSION" : "", larger ? "  MEMORY REGRESSION" : "");
+            if(slower || larger) regressions++;
+        }
+    }
+    return regressions;
+}
+
+[[noreturn]] void
+usage()
+{
+    fprintf(stderr, "usage: %s OPTIONS\n", progname);
+    fprintf(stderr, "Wildland Fire Simulator scaling study\n\nOptions:\n");
+    fprintf(stderr, "\t-h\tDisplays this help.\n");
+    fprintf(stderr, "\t-x <simulator>\tPath of the WildlandFireSimulator executable.\n");
+    fprintf(stderr, "\t-s <sizes>\tComma separated landscape widths in cells (default 100,...,20000).\n");
+    fprintf(stderr, "\t-j <thread-counts>\tComma separated thread counts (default 1, 2, 4, ... all cores).\n");
+    fprintf(stderr, "\t-d <maximal-fire-duration>\tMaximal duration of the fires (timesteps).\n");
+    fprintf(stderr, "\t-r <repetitions>\tRuns per configuration, the median wall time is reported.\n");
+    fprintf(stderr, "\t-o <result-file>\tJSON file for the results (default: standard output).\n");
+    fprintf(stderr, "\t-b <baseline-file>\tResult file to compare against.\n");
+    fprintf(stderr, "\t-t <threshold>\tTolerated relative increase of wall time (default 0.10).\n");
+    fprintf(stderr, "\t-m <threshold>\tTolerated relative increase of peak memory (default 0.10).\n");
+    exit(1);
+}
+
+void
+parseArguments(int argc, char *argv[])
+{
+    progname = argv[0];
+
+    while (argc > 1 && argv[1][0] == '-') {
+        if (argc < 3)
+            usage();
+        switch (argv[1][1]) {
+        case 'h':
+        default:
+            usage();
+        case 'x':
+            simulator = argv[2];
+            break;
+        case 's':
+            landscapeSizes = parseList(argv[2]);
+            break;
+        case 'j':
+            threadCounts = parseList(argv[2]);
+            break;
+        case 'd':
+            maximalFireDuration = atoi(argv[2]);
+            break;
+        case 'r':
+            repetitions = atoi(argv[2]);
+            break;
+        case 'o':
+            resultFile = argv[2];
+            break;
+        case 'b':
+            baselineFile = argv[2];
+            break;
+        case 't':
+            timeThreshold = atof(argv[2]);
+            break;
+        case 'm':
+            memoryThreshold = atof(argv[2]);
+            break;
+        }
+        argc -= 2;
+        argv += 2;
+    }
+    if (repetitions < 1 || landscapeSizes.empty())
+        usage();
+    if (threadCounts.empty()) {
+        int cores = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+        for (int threads = 1; threads < cores; threads *= 2)
+            threadCounts.push_back(threads);
+        threadCounts.push_back(cores);
+    }
+}
+
+}
+
+int main(int argc, char *argv[])
+{
+    parseArguments(argc, argv);
+
+    //the simulator is run from temporary directories
+    char *simulatorPath = realpath(simulator, nullptr);
+    if (!simulatorPath) {
+        fprintf(stderr, "error: simulator %s not found\n", simulator);
+        return 1;
+    }
+
+    std::vector<RunResult> results;
+    for (int size : landscapeSizes) {
+        for (int threads : threadCounts) {
+            for (const WindRegime &wind : windRegimes) {
+                std::vector<RunResult> runs;
+                for (int r = 0; r < repetitions; r++)
+                    runs.push_back(runSimulator(simulatorPath, size, threads, wind));
+                std::sort(runs.begin(), runs.end(), [](const RunResult &a, const RunResult &b) {
+                    return a.wallSeconds < b.wallSeconds;
+                });
+                RunResult result = runs[runs.size() / 2];
+                for (const RunResult &run : runs)
+                    result.peakResidentSetKilobytes = std::max(result.peakResidentSetKilobytes,
+                                                               run.peakResidentSetKilobytes);
+                fprintf(stderr, "size %6d  threads %3d  %-6s wind  %10.4f s  %9ld kB  %12lld cells burned\n",
+                        size, threads, wind.name, result.wallSeconds, result.peakResidentSetKilobytes,
+                        result.cellsBurned);
+                results.push_back(result);
+            }
+        }
+    }
+    free(simulatorPath);
+
+    FILE *output = stdout;
+    if (resultFile) {
+        output = fopen(resultFile, "w");
+        if (!output) {
+            fprintf(stderr, "error: cannot write %s\n", resultFile);
+            return 1;
+        }
+    }
+    fprintf(output, "{\n  \"maximal_fire_duration\": %d,\n  \"repetitions\": %d,\n  \"runs\": [\n",
+            maximalFireDuration, repetitions);
+    for (size_t i = 0; i < results.size(); i++)
+        writeResult(output, results[i], i + 1 == results.size());
+    fprintf(output, "  ]\n}\n");
+    if (output != stdout)
+        fclose(output);
+
+    if (baselineFile) {
+        int regressions = compareWithBaseline(results, readBaseline(baselineFile));
+        if (regressions > 0) {
+            fprintf(stderr, "%d regression(s) against %s\n", regressions, baselineFile);
+            return 2;
+        }
+    }
+    return 0;
+}
@@ -7,7 +7,9 @@ namespace wildland_firesim {
 
 /*!
  * \brief The Cell class
- * holds the vegetation parameters and the cell state.
+ * holds the vegetation parameters and the cell state. The state is stamped with the state epoch of
+ * the landscape it was set in; a state of an earlier epoch is stale and reads as unburned, so the
+ * landscape is reset for the next fire by starting a new epoch.
  */
 class Cell
 {
@@ -16,7 +18,30 @@ public:
     float deadBiomass;
     float liveBiomass;
 
-    CellState state;
+    /*!
+     * \brief getState
+     * \param epoch state epoch of the landscape
+     * \return state of the cell, unburned if it was set in another epoch
+     */
+    CellState getState(std::uint16_t epoch) const noexcept
+    {
+        return m_stateEpoch == epoch ? m_state : CellState::Unburned;
+    }
+
+    /*!
+     * \brief setState
+     * \param state
+     * \param epoch state epoch of the landscape
+     */
+    void setState(CellState state, std::uint16_t epoch) noexcept
+    {
+        m_state = state;
+        m_stateEpoch = epoch;
+    }
+
+private:
+    CellState m_state;
+    std::uint16_t m_stateEpoch;
 };
 
 }  // namespace wildland_firesim
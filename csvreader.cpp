@@ -60,11 +60,12 @@ Reader::parse(std::string fileName)
                 }
             }
             //extract first value
-            currentValue = line.substr(0, pos[0]-1);
+            currentValue = line.substr(0, pos[0]);
             push_result();
             for(size_t j = 0; j < pos.size(); j++){
-                // starting position,
-                currentValue = line.substr(pos[j]+1,pos[j+1]-pos[j]-1);
+                // starting position, the last value ends with the line
+                size_t end = (j + 1 < pos.size()) ? pos[j+1] : line.length();
+                currentValue = line.substr(pos[j]+1, end-pos[j]-1);
                 push_result();
             }
             //push_result();
@@ -1,127 +1,309 @@
 #include "fire.h"
+#include "WFS_profiling.h"
+#include "WFS_tracing.h"
+#include "WFS_probes.h"
+#include "WFS_ignition.h"
+#include "WFS_allocations.h"
+#include "WFS_scheduler.h"
 
 namespace wildland_firesim {
 namespace {
 
 constexpr int CellsBorderingVertex = 4;
-constexpr int numberOfCellInternSpreadDirections = 3;
+constexpr int numberOfCellInternSpreadDirections = CellInternSpreadDirectionsCount;
+//fronts of fewer burning cells are spread within cells by one thread by default
+constexpr size_t ParallelSpreadMinimumCells = 8192;
 
 }
 
-Fire::Fire() : burningCellInformationVector()
+Fire::Fire() : burningCellInformationVector(), statistics(), m_weather(), m_weatherEpoch(0),
+    m_random(&utility::globalRandomStream()), m_touchedBounds(CellBounds::none()), m_frontSortInterval(0),
+    m_timestepsSinceFrontSort(0), m_scheduler(nullptr),
+    m_parallelSpreadMinimumCells(ParallelSpreadMinimumCells), m_spreadArena(), pointFireSources(nullptr),
+    numberOfPointFireSources(0)
 {
 
 }
 
 void
-Fire::spreadFire(LandscapeInterface *landscape, const FireWeatherVariables &weather, int timestepLength)
+Fire::setRandomStream(utility::RandomStream *random)
 {
-    //create empty pointFireSource vector and correspondend vector with remaining time
-    std::vector<pointFireSourceInformation> pointFireSourceInformationVector;
+    m_random = random;
+}
+
+utility::RandomStream *
+Fire::getRandomStream() const noexcept
+{
+    return m_random;
+}
+
+void
+Fire::setTaskScheduler(TaskScheduler *scheduler)
+{
+    m_scheduler = scheduler;
+}
+
+void
+Fire::setParallelSpreadMinimumCells(size_t cells)
+{
+    m_parallelSpreadMinimumCells = std::max<size_t>(cells, 1);
+}
+
+void
+Fire::setFrontSortInterval(int timesteps)
+{
+    m_frontSortInterval = timesteps;
+}
+
+void
+Fire::resetFire()
+{
+    //set counter for burning cells to zero as no cell is burning before the fire is ignited
+    numberOfCellsBurning = 0;
+    burningCellInformationVector.clear();
+    statistics = FireStatistics();
+    m_touchedBounds = CellBounds::none();
+    m_timestepsSinceFrontSort = 0;
+}
+
+const CellBounds &
+Fire::getTouchedBounds() const noexcept
+{
+    return m_touchedBounds;
+}
+
+void
+Fire::setFireWeather(const FireWeatherVariables &weather)
+{
+    m_weather = weather;
+    //invalidates the rates of spread cached by the burning cells
+    m_weatherEpoch++;
+}
+
+void
+Fire::updateSpreadCache(burningCellInformation &burningCell, const Cell *cell)
+{
+    //calculate input variables for fire spread
+    float fuelLoad = cell->liveBiomass +
+            cell->deadBiomass;
+    float degreeOfCuring = cell->deadBiomass / fuelLoad;
+    float fuelMoisture = estimateGrassFuelMoisture(m_weather.temperature,
+                                                   m_weather.relHumidity,
+                                                   degreeOfCuring);
+    float availableFuel = fuelLoad * estimateFuelAvailability(fuelMoisture);
+
+    //calculate headfire rate of spread
+    float headFireRateOfSpread = calculateHeadFireRateOfSpread(fuelLoad, fuelMoisture,
+                                                               m_weather.relHumidity,
+                                                               m_weather.windSpeed);
+
+    for(size_t k = 0; k<numberOfCellInternSpreadDirections; k++){
+        burningCell.rateOfSpread[k] = calculateDirectionalRateOfSpread(m_weather.windSpeed,
+                                                                       m_weather.windDirection,
+                                                                       headFireRateOfSpread,
+                                                                       burningCell.spreadDirection[k]);
+        burningCell.firelineIntensity[k] = calculateFirelineIntensity(burningCell.rateOfSpread[k],
+                                                                      availableFuel);
+    }
+    burningCell.weatherEpoch = m_weatherEpoch;
+}
+
+void
+Fire::spreadFire(LandscapeInterface *landscape, int timestepLength)
+{
+    WILDLAND_ALLOCATION_SCOPE();
+    //release the buffers of the previous timestep, keeping their memory
+    m_spreadArena.reset();
+
+    if(m_frontSortInterval > 0 && ++m_timestepsSinceFrontSort >= m_frontSortInterval){
+        WILDLAND_TRACE_SPAN("sortFront");
+        sortFront(landscape);
+        m_timestepsSinceFrontSort = 0;
+    }
 
     //calculate distance to cell boundaries
     distance_to_cell_boundary[0] = static_cast<float>(landscape->getCellSize());
     distance_to_cell_boundary[1] = std::sqrt(2.f) * landscape->getCellSize();
     distance_to_cell_boundary[2] = static_cast<float>(landscape->getCellSize());
 
+    WILDLAND_PROFILE_COUNT(FrontSize, static_cast<long long>(burningCellInformationVector.size()));
+    tracing::counter("frontSize", static_cast<long long>(burningCellInformationVector.size()));
+    WILDLAND_PROBE1(step__begin, numberOfCellsBurning);
+    //each spread direction of a burning cell reaches its vertex at most once
+    pointFireSources = m_spreadArena.allocate<pointFireSourceInformation>(
+                burningCellInformationVector.size() * numberOfCellInternSpreadDirections);
+    numberOfPointFireSources = 0;
+    int numberOfCellsIgnited = statistics.numberOfCellsIgnited;
+    {
+        WILDLAND_PROFILE_PHASE(SpreadWithinCells);
+        WILDLAND_TRACE_SPAN("spreadWithinCells");
+        spreadWithinCells(landscape, timestepLength);
+    }
+    WILDLAND_PROFILE_COUNT(PointFireSources, static_cast<long long>(numberOfPointFireSources));
+    {
+        WILDLAND_PROFILE_PHASE(BurnOutCells);
+        WILDLAND_TRACE_SPAN("burnOutCells");
+        burnOutCells(landscape);
+    }
+    {
+        WILDLAND_PROFILE_PHASE(IgniteCells);
+        WILDLAND_TRACE_SPAN("igniteCells");
+        igniteCells(landscape);
+    }
+    tracing::counter("ignitions", statistics.numberOfCellsIgnited - numberOfCellsIgnited);
+    WILDLAND_PROBE2(step__end, numberOfCellsBurning, statistics.numberOfCellsIgnited - numberOfCellsIgnited);
+    WILDLAND_PROFILE_END_STEP();
+}
+
+void
+Fire::sortFront(const LandscapeInterface *landscape)
+{
+    //storage index and position of each burning cell
+    size_t numberOfCells = burningCellInformationVector.size();
+    std::pair<std::size_t, size_t> *frontOrder = m_spreadArena.allocate<std::pair<std::size_t, size_t>>(numberOfCells);
+    for(size_t i = 0; i < numberOfCells; i++){
+        const burningCellInformation &burningCell = burningCellInformationVector[i];
+        new (&frontOrder[i]) std::pair<std::size_t, size_t>(landscape->getCellIndex(burningCell.xCoord,
+                                                                                     burningCell.yCoord), i);
+    }
+    std::sort(frontOrder, frontOrder + numberOfCells);
+    burningCellInformation *sortedCells = m_spreadArena.allocate<burningCellInformation>(numberOfCells);
+    for(size_t i = 0; i < numberOfCells; i++){
+        sortedCells[i] = burningCellInformationVector[frontOrder[i].second];
+    }
+    std::copy(sortedCells, sortedCells + numberOfCells, burningCellInformationVector.begin());
+}
+
+void
+Fire::spreadWithinCells(LandscapeInterface *landscape, int timestepLength)
+{
     // start cellwise routine
     // simulate fire spread within cells (per timestep)
     // iterate over vector with coordinates of all cells burning
-    for(size_t i = 0; i<burningCellInformationVector.size(); i++){
-        int x = burningCellInformationVector[i].xCoord;
-        int y = burningCellInformationVector[i].yCoord;
+    size_t numberOfCells = burningCellInformationVector.size();
+    if(m_scheduler && m_scheduler->getNumberOfThreads() > 1 && numberOfCells >= m_parallelSpreadMinimumCells){
+        //cells are independent within the routine: each writes its point fire sources to its own place,
+        //and they are appended in the order of the cells afterwards, so the fire is the same
+        unsigned char *numberOfSources = m_spreadArena.allocate<unsigned char>(numberOfCells);
+        //the body captures two pointers only, which std::function holds without allocating
+        struct {
+            LandscapeInterface *landscape;
+            int timestepLength;
+            unsigned char *numberOfSources;
+        } pieces{landscape, timestepLength, numberOfSources};
+        size_t grainSize = std::max<size_t>(m_parallelSpreadMinimumCells / 4, 1);
+        m_scheduler->parallelFor(0, numberOfCells, grainSize, [this, &pieces](size_t begin, size_t end){
+            //the pieces may run on other threads, whose allocations count for the timestep as well
+            WILDLAND_ALLOCATION_SCOPE();
+            for(size_t i = begin; i < end; i++){
+                pieces.numberOfSources[i] = static_cast<unsigned char>(
+                            spreadWithinCell(burningCellInformationVector[i], pieces.landscape, pieces.timestepLength,
+                                             pointFireSources + i * numberOfCellInternSpreadDirections));
+            }
+        });
+        for(size_t i = 0; i < numberOfCells; i++){
+            for(int k = 0; k < numberOfSources[i]; k++){
+                pointFireSources[numberOfPointFireSources++] = pointFireSources[i * numberOfCellInternSpreadDirections + k];
+            }
+            statistics.maximumFirelineIntensity = std::max(statistics.maximumFirelineIntensity,
+                                                           burningCellInformationVector[i].meanFirelineIntensity);
+        }
+        return;
+    }
+    for(size_t i = 0; i<numberOfCells; i++){
+        numberOfPointFireSources += spreadWithinCell(burningCellInformationVector[i], landscape, timestepLength,
+                                                     pointFireSources + numberOfPointFireSources);
+        statistics.maximumFirelineIntensity = std::max(statistics.maximumFirelineIntensity,
+                                                       burningCellInformationVector[i].meanFirelineIntensity);
+    }//end cellwise routine for firespread
+}
 
-        //access the respective cell
-        Cell* cell = landscape->getCellInformation(x,y);
+int
+Fire::spreadWithinCell(burningCellInformation &burningCell, const LandscapeInterface *landscape,
+                       int timestepLength, pointFireSourceInformation *sources)
+{
+    int numberOfSources = 0;
+    //rates of spread only change with the fire weather, so they are recalculated once per epoch
+    if(burningCell.weatherEpoch != m_weatherEpoch){
+        int x = burningCell.xCoord;
+        int y = burningCell.yCoord;
+        updateSpreadCache(burningCell, landscape->getCellInformation(x,y));
+    }
 
-        //calculate input variables for fire spread
-        float fuelLoad = cell->liveBiomass +
-                cell->deadBiomass;
-        float degreeOfCuring = cell->deadBiomass / fuelLoad;
-        float fuelMoisture = estimateGrassFuelMoisture(weather.temperature,
-                                                       weather.relHumidity,
-                                                       degreeOfCuring);
-        float availableFuel = fuelLoad * estimateFuelAvailability(fuelMoisture);
-
-        //calculate headfire rate of spread
-        //float headFireRateOfSpread = calculateHeadFireRateOfSpread(fuelMoisture, weather.windSpeed);
-        float headFireRateOfSpread = calculateHeadFireRateOfSpread(fuelLoad, fuelMoisture,
-                                                                   weather.relHumidity,
-                                                                   weather.windSpeed);
-
-        // initialize fireline Intensity sum for vegetation effects
-        float sumIntensity = 0.0;
-
-        // access burn status (cell intern routine)
-        for(size_t k = 0; k<burningCellInformationVector[i].burnStatus.size(); k++){
-            //get rate of spread within the burning cell
-            // vector also required for ignition of point fire source
-            float rateOfSpread = calculateDirectionalRateOfSpread(weather.windSpeed,
-                                                                  weather.windDirection,
-                                                                  headFireRateOfSpread,
-                                                                  burningCellInformationVector[i].spreadDirection[k]);
-
-            //sum fireline within cell
-            sumIntensity = sumIntensity+calculateFirelineIntensity(rateOfSpread,availableFuel);
-
-            //if vertex is already reached by the fire continue.
-            if(burningCellInformationVector[i].burnStatus[k] >= 1.f) continue;
-
-            //update burn status
-            burningCellInformationVector[i].burnStatus[k] = (rateOfSpread*timestepLength)/distance_to_cell_boundary[k] +
-                    burningCellInformationVector[i].burnStatus[k];
-
-            if(burningCellInformationVector[i].burnStatus[k] >= 1.f){
-                //new point fire source
-                pointFireSourceInformation newPointFireSource;
-                //establish new point fire source by adding vertex coordinates to pointFireSources vector
-                if(burningCellInformationVector[i].spreadDirection[k]==1){
-                    newPointFireSource.uCoord = burningCellInformationVector[i].uCoordSource;
-                    newPointFireSource.vCoord = burningCellInformationVector[i].vCoordSource+1;
-                }
-                if(burningCellInformationVector[i].spreadDirection[k]==2){
-                    newPointFireSource.uCoord = burningCellInformationVector[i].uCoordSource+1;
-                    newPointFireSource.vCoord = burningCellInformationVector[i].vCoordSource+1;
-                }
-                if(burningCellInformationVector[i].spreadDirection[k]==3){
-                    newPointFireSource.uCoord = burningCellInformationVector[i].uCoordSource+1;
-                    newPointFireSource.vCoord = burningCellInformationVector[i].vCoordSource;
-                }
-                if(burningCellInformationVector[i].spreadDirection[k]==4){
-                    newPointFireSource.uCoord = burningCellInformationVector[i].uCoordSource+1;
-                    newPointFireSource.vCoord = burningCellInformationVector[i].vCoordSource-1;
-                }
-                if(burningCellInformationVector[i].spreadDirection[k]==5){
-                    newPointFireSource.uCoord = burningCellInformationVector[i].uCoordSource;
-                    newPointFireSource.vCoord = burningCellInformationVector[i].vCoordSource-1;
-                }
-                if(burningCellInformationVector[i].spreadDirection[k]==6){
-                    newPointFireSource.uCoord = burningCellInformationVector[i].uCoordSource-1;
-                    newPointFireSource.vCoord = burningCellInformationVector[i].vCoordSource-1;
-                }
-                if(burningCellInformationVector[i].spreadDirection[k]==7){
-                    newPointFireSource.uCoord = burningCellInformationVector[i].uCoordSource-1;
-                    newPointFireSource.vCoord = burningCellInformationVector[i].vCoordSource;
-                }
-                if(burningCellInformationVector[i].spreadDirection[k]==8){
-                    newPointFireSource.uCoord = burningCellInformationVector[i].uCoordSource-1;
-                    newPointFireSource.vCoord = burningCellInformationVector[i].vCoordSource+1;
-                }
-                //calculate fireline intensity of the section of the fire front
-                newPointFireSource.fireIntensity = (calculateFirelineIntensity(rateOfSpread,availableFuel));
-                //calculate remaining time at certain pointFireSource
-                newPointFireSource.remainingTime = (static_cast<int>(round(((burningCellInformationVector[i].burnStatus[k]-1) *
-                                                                            distance_to_cell_boundary[k]) / rateOfSpread)));
-                //append new point fire source to vector
-                pointFireSourceInformationVector.push_back(newPointFireSource);
-                //set burnStatus to 1
-                burningCellInformationVector[i].burnStatus[k] = 1.f;
+    // initialize fireline Intensity sum for vegetation effects
+    float sumIntensity = 0.0;
+
+    // access burn status (cell intern routine)
+    for(size_t k = 0; k<numberOfCellInternSpreadDirections; k++){
+        //get rate of spread within the burning cell
+        // vector also required for ignition of point fire source
+        float rateOfSpread = burningCell.rateOfSpread[k];
+
+        //sum fireline within cell
+        sumIntensity = sumIntensity+burningCell.firelineIntensity[k];
+
+        //if vertex is already reached by the fire continue.
+        if(burningCell.burnStatus[k] >= 1.f) continue;
+
+        //update burn status
+        burningCell.burnStatus[k] = (rateOfSpread*timestepLength)/distance_to_cell_boundary[k] +
+                burningCell.burnStatus[k];
+
+        if(burningCell.burnStatus[k] >= 1.f){
+            //new point fire source
+            pointFireSourceInformation newPointFireSource;
+            //establish new point fire source by adding vertex coordinates to pointFireSources vector
+            if(burningCell.spreadDirection[k]==1){
+                newPointFireSource.uCoord = burningCell.uCoordSource;
+                newPointFireSource.vCoord = burningCell.vCoordSource+1;
             }
-        }//end cell intern routine
-        burningCellInformationVector[i].meanFirelineIntensity = sumIntensity /
-                burningCellInformationVector[i].burnStatus.size();
-    }//end cellwise routine for firespread
+            if(burningCell.spreadDirection[k]==2){
+                newPointFireSource.uCoord = burningCell.uCoordSource+1;
+                newPointFireSource.vCoord = burningCell.vCoordSource+1;
+            }
+            if(burningCell.spreadDirection[k]==3){
+                newPointFireSource.uCoord = burningCell.uCoordSource+1;
+                newPointFireSource.vCoord = burningCell.vCoordSource;
+            }
+            if(burningCell.spreadDirection[k]==4){
+                newPointFireSource.uCoord = burningCell.uCoordSource+1;
+                newPointFireSource.vCoord = burningCell.vCoordSource-1;
+            }
+            if(burningCell.spreadDirection[k]==5){
+                newPointFireSource.uCoord = burningCell.uCoordSource;
+                newPointFireSource.vCoord = burningCell.vCoordSource-1;
+            }
+            if(burningCell.spreadDirection[k]==6){
+                newPointFireSource.uCoord = burningCell.uCoordSource-1;
+                newPointFireSource.vCoord = burningCell.vCoordSource-1;
+            }
+            if(burningCell.spreadDirection[k]==7){
+                newPointFireSource.uCoord = burningCell.uCoordSource-1;
+                newPointFireSource.vCoord = burningCell.vCoordSource;
+            }
+            if(burningCell.spreadDirection[k]==8){
+                newPointFireSource.uCoord = burningCell.uCoordSource-1;
+                newPointFireSource.vCoord = burningCell.vCoordSource+1;
+            }
+            //calculate fireline intensity of the section of the fire front
+            newPointFireSource.fireIntensity = burningCell.firelineIntensity[k];
+            //calculate remaining time at certain pointFireSource
+            newPointFireSource.remainingTime = (static_cast<int>(round(((burningCell.burnStatus[k]-1) *
+                                                                        distance_to_cell_boundary[k]) / rateOfSpread)));
+            //append new point fire source
+            sources[numberOfSources++] = newPointFireSource;
+            //set burnStatus to 1
+            burningCell.burnStatus[k] = 1.f;
+        }
+    }//end cell intern routine
+    burningCell.meanFirelineIntensity = sumIntensity /
+            numberOfCellInternSpreadDirections;
+    return numberOfSources;
+}
 
+void
+Fire::burnOutCells(LandscapeInterface *landscape)
+{
     //cellwise routine for burn-out of cells
     for(size_t i = 0; i < burningCellInformationVector.size(); i++){
         int x = burningCellInformationVector[i].xCoord;
@@ -132,28 +314,35 @@ Fire::spreadFire(LandscapeInterface *landscape, const FireWeatherVariables &weat
 
         //summation of burnstatus within respective cell
         float summarizedBurnStatus = 0.f;
-        for(size_t q = 0; q<burningCellInformationVector[i].burnStatus.size(); q++){
+        for(size_t q = 0; q<numberOfCellInternSpreadDirections; q++){
             summarizedBurnStatus = summarizedBurnStatus + burningCellInformationVector[i].burnStatus[q];
         }
 
         //if all burnstates are 1 or mean intensity is lower 20.0 (self-extinguished fire in Gauteng), the cell burns out.
-        if(summarizedBurnStatus >= burningCellInformationVector[i].burnStatus.size() ||
+        if(summarizedBurnStatus >= numberOfCellInternSpreadDirections ||
                 ((burningCellInformationVector[i].meanFirelineIntensity) <= 20.f)){
 
-            cell->state = CellState::BurnedOut;
+            cell->setState(CellState::BurnedOut, landscape->getStateEpoch());
+            WILDLAND_PROBE2(cell__burnout, x, y);
+            statistics.numberOfCellsBurnedOut++;
+            statistics.sumOfFirelineIntensity += burningCellInformationVector[i].meanFirelineIntensity;
             //remove burned-out cells from burning cell vector
             burningCellInformationVector.erase(burningCellInformationVector.begin() + i);
             numberOfCellsBurning--;
         }
     } //end cellwise routine for cell burn-out
+}
 
+void
+Fire::igniteCells(LandscapeInterface *landscape)
+{
     //ignition of cells
     //point fire source has to be active
-    if(!pointFireSourceInformationVector.empty()){
+    if(numberOfPointFireSources > 0){
         //iteration over each vertex
-        for(size_t i = 0; i<pointFireSourceInformationVector.size(); i++){
-            int u = pointFireSourceInformationVector[i].uCoord;
-            int v = pointFireSourceInformationVector[i].vCoord;
+        for(size_t i = 0; i<numberOfPointFireSources; i++){
+            int u = pointFireSources[i].uCoord;
+            int v = pointFireSources[i].vCoord;
 
             //create array of coordinates of cells sharing a vertex
             //direction vector has been changed so north will be shown up.
@@ -170,7 +359,7 @@ Fire::spreadFire(LandscapeInterface *landscape, const FireWeatherVariables &weat
 
                 //access the respective cell
                 Cell* cell = landscape->getCellInformation(x,y);
-                if(cell->state == CellState::BurnedOut || cell->state == CellState::Burning) continue;
+                if(cell->getState(landscape->getStateEpoch()) != CellState::Unburned) continue;
                 //check for vegetation type
                 if (cell->type == VegetationType::NonFlammable) continue;
                 if (cell->type == VegetationType::Grass){
@@ -178,42 +367,39 @@ Fire::spreadFire(LandscapeInterface *landscape, const FireWeatherVariables &weat
                     float fuelLoad = cell->liveBiomass +
                             cell->deadBiomass;
                     float degreeOfCuring = (cell->deadBiomass/ fuelLoad);
-                    float fuelMoisture = estimateGrassFuelMoisture(weather.temperature,
-                                                                   weather.relHumidity,
+                    float fuelMoisture = estimateGrassFuelMoisture(m_weather.temperature,
+                                                                   m_weather.relHumidity,
                                                                    degreeOfCuring);
 
                     // test for ignition
-                    if(utility::random() < calculateCellIgnitionProbability(pointFireSourceInformationVector[i].fireIntensity,
+                    WILDLAND_PROFILE_COUNT(IgnitionTests, 1);
+                    if(m_random->random() < calculateCellIgnitionProbability(pointFireSources[i].fireIntensity,
                                                                           fuelMoisture)){
+                        WILDLAND_PROFILE_COUNT(Ignitions, 1);
                         //set cell state to burning
                         burningCellInformation newBurningCell;
-                        newBurningCell.uCoordSource = pointFireSourceInformationVector[i].uCoord;
-                        newBurningCell.vCoordSource = pointFireSourceInformationVector[i].vCoord;
-                        cell->state = CellState::Burning;
+                        newBurningCell.uCoordSource = pointFireSources[i].uCoord;
+                        newBurningCell.vCoordSource = pointFireSources[i].vCoord;
+                        cell->setState(CellState::Burning, landscape->getStateEpoch());
+                        m_touchedBounds.include(x, y);
+                        WILDLAND_PROBE2(cell__ignite, x, y);
                         newBurningCell.meanFirelineIntensity = 0.0;
                         numberOfCellsBurning++;
+                        statistics.numberOfCellsIgnited++;
                         //add coordinates to cellsBurning vector
                         newBurningCell.xCoord = cellsToIgnite[l][0];
                         newBurningCell.yCoord = cellsToIgnite[l][1];
                         //add direction to spreadDirection vector
-                        //add travel distance of 0 to burnStatus vector
                         for(size_t ll=0; ll<numberOfCellInternSpreadDirections; ll++){
-                            newBurningCell.spreadDirection.push_back(direction[l][ll]);
-                            //simulate fire spread using the remaining time
-                            float headFireRateOfSpread = calculateHeadFireRateOfSpread(fuelLoad, fuelMoisture,
-                                                                                       weather.relHumidity,
-                                                                                       weather.windSpeed);
-                            /*
-                            float headFireRateOfSpread = calculateHeadFireRateOfSpread(fuelMoisture,
-                                                                                       weather.windSpeed);
-                            */
-                            float rateOfSpread =  calculateDirectionalRateOfSpread(weather.windSpeed,
-                                                                                   weather.windDirection,
-                                                                                   headFireRateOfSpread,
-                                                                                   newBurningCell.spreadDirection[ll]);
-                            //update burn status
-                            newBurningCell.burnStatus.push_back((rateOfSpread*pointFireSourceInformationVector[i].remainingTime) /
-                                                                distance_to_cell_boundary[ll]);
+                            newBurningCell.spreadDirection[ll] = direction[l][ll];
+                        }
+                        //rates of spread are kept for the following timesteps of the current epoch
+                        updateSpreadCache(newBurningCell, cell);
+                        //simulate fire spread using the remaining time
+                        //add travel distance to burnStatus vector
+                        for(size_t ll=0; ll<numberOfCellInternSpreadDirections; ll++){
+                            newBurningCell.burnStatus[ll] = (newBurningCell.rateOfSpread[ll]*pointFireSources[i].remainingTime) /
+                                    distance_to_cell_boundary[ll];
                         }
                         burningCellInformationVector.push_back(newBurningCell);
                     }
@@ -224,16 +410,27 @@ Fire::spreadFire(LandscapeInterface *landscape, const FireWeatherVariables &weat
 }
 
 void
-Fire::initiateWildFire(LandscapeInterface *landscape, const FireWeatherVariables &weather)
+Fire::initiateWildFire(LandscapeInterface *landscape)
 {
-    //set counter for burning cells to zero as no cell is burning before the fire is ignited
-    numberOfCellsBurning = 0;
-    burningCellInformationVector.clear();
+    resetFire();
 
     //choose random vertex within landscape grid
-    int u = utility::random(landscape->getWidth() - 1);
-    int v = utility::random(landscape->getHeight() - 1);
+    int u = m_random->random(landscape->getWidth() - 1);
+    int v = m_random->random(landscape->getHeight() - 1);
+
+    igniteWildFireAtVertex(landscape, u, v);
+}
+
+void
+Fire::initiateWildFire(LandscapeInterface *landscape, int u, int v)
+{
+    resetFire();
+    igniteWildFireAtVertex(landscape, u, v);
+}
 
+void
+Fire::igniteWildFireAtVertex(LandscapeInterface *landscape, int u, int v)
+{
     //create array of coordinates of cells sharing a vertex
     int cellsToIgnite[CellsBorderingVertex][2] = {{u,v},{u,v-1},{u-1,v-1},{u-1,v}};
     int direction[CellsBorderingVertex][numberOfCellInternSpreadDirections] = {{1,2,3},{3,4,5},{5,6,7},{7,8,1}};
@@ -253,31 +450,34 @@ Fire::initiateWildFire(LandscapeInterface *landscape, const FireWeatherVariables
         if (cell->type == VegetationType::Grass){
             //check for minimal fuel requirement
             float fuelLoad = cell->deadBiomass + cell->liveBiomass;
-            float minimumFuel = 200;
-            if(fuelLoad >= minimumFuel){
+            if(fuelLoad >= MinimumIgnitionFuelLoad){
                 //calculate fuel moisture
                 float degreeOfCuring = (cell->deadBiomass / fuelLoad);
-                float fuelMoisture = estimateGrassFuelMoisture(weather.temperature,
-                                                               weather.relHumidity,
+                float fuelMoisture = estimateGrassFuelMoisture(m_weather.temperature,
+                                                               m_weather.relHumidity,
                                                                degreeOfCuring);
                 //check for ignition
-                if(utility::random() < calculateInitialIgnitionProbability(fuelMoisture)){
+                if(m_random->random() < calculateInitialIgnitionProbability(fuelMoisture)){
                     //set cell state to burning
                     burningCellInformation newBurningCell;
                     newBurningCell.uCoordSource = u;
                     newBurningCell.vCoordSource = v;
-                    cell->state = CellState::Burning;
+                    newBurningCell.weatherEpoch = m_weatherEpoch - 1;
+                    cell->setState(CellState::Burning, landscape->getStateEpoch());
+                    m_touchedBounds.include(x, y);
+                    WILDLAND_PROBE2(cell__ignite, x, y);
                     //add coordinates to vector of burning cells
                     newBurningCell.xCoord = x;
                     newBurningCell.yCoord = y;
                     //add burnstatus into vector
                     for(int ll=0; ll<numberOfCellInternSpreadDirections; ll++){
-                        newBurningCell.spreadDirection.push_back(direction[l][ll]);
-                        newBurningCell.burnStatus.push_back(0.f);
+                        newBurningCell.spreadDirection[ll] = direction[l][ll];
+                        newBurningCell.burnStatus[ll] = 0.f;
                     }
-                    burningCellInformationVector.push_back(newBurningCell);
                     newBurningCell.meanFirelineIntensity = 0.0;
+                    burningCellInformationVector.push_back(newBurningCell);
                     numberOfCellsBurning++;
+                    statistics.numberOfCellsIgnited++;
                 }
             }
         }
@@ -288,27 +488,40 @@ Fire::initiateWildFire(LandscapeInterface *landscape, const FireWeatherVariables
 void
 Fire::setCenteredIgnitionPoint(LandscapeInterface *landscape)
 {
-    //set counter for burning cells to zero as no cell is burning before the fire is ignited
-    numberOfCellsBurning = 0;
-    burningCellInformationVector.clear();
-
     //calculate coordinates of central vertex
     int u = static_cast<int>(round(landscape->getWidth()/2));
     int v = static_cast<int>(round(landscape->getHeight()/2));
 
+    setIgnitionPoint(landscape, u, v);
+}
+
+void
+Fire::setIgnitionPoint(LandscapeInterface *landscape, int u, int v)
+{
+    resetFire();
+    igniteVertex(landscape, u, v);
+}
+
+void
+Fire::igniteVertex(LandscapeInterface *landscape, int u, int v)
+{
     //create array of coordinates of cells sharing a vertex
     int cellsToIgnite[CellsBorderingVertex][2] = {{u,v},{u,v-1},{u-1,v-1},{u-1,v}};
     int direction[CellsBorderingVertex][numberOfCellInternSpreadDirections] = {{1,2,3},{3,4,5},{5,6,7},{7,8,1}};
 
-    /*
-    * Fixed Ignition of Centered Cell in quadratic landscapes
-    */
     //try to ignite all adjacent cells
     for(int l = 0; l<CellsBorderingVertex; l++){
         int x = cellsToIgnite[l][0];
         int y = cellsToIgnite[l][1];
+
+        //check if coordinates are within landscape
+        if(x > landscape->getWidth()-1 || x < 0) continue;
+        if(y > landscape->getHeight()-1 || y < 0) continue;
+
         //access the respective cell
         Cell* cell = landscape->getCellInformation(x,y);
+        //cells shared with a vertex lit before are already burning
+        if(cell->getState(landscape->getStateEpoch()) != CellState::Unburned) continue;
         //check for vegetation type
         if (cell->type == VegetationType::Grass){
             //check for minimal fuel requirement
@@ -319,33 +532,36 @@ Fire::setCenteredIgnitionPoint(LandscapeInterface *landscape)
                     burningCellInformation newBurningCell;
                     newBurningCell.uCoordSource = u;
                     newBurningCell.vCoordSource = v;
-                    cell->state = CellState::Burning;
+                    newBurningCell.weatherEpoch = m_weatherEpoch - 1;
+                    cell->setState(CellState::Burning, landscape->getStateEpoch());
+                    m_touchedBounds.include(x, y);
+                    WILDLAND_PROBE2(cell__ignite, x, y);
                     //add coordinates to vector of burning cells
                     newBurningCell.xCoord = x;
                     newBurningCell.yCoord = y;
                     //add burnstatus into vector
                     for(int ll=0; ll<numberOfCellInternSpreadDirections; ll++){
-                        newBurningCell.spreadDirection.push_back(direction[l][ll]);
-                        newBurningCell.burnStatus.push_back(0.f);
+                        newBurningCell.spreadDirection[ll] = direction[l][ll];
+                        newBurningCell.burnStatus[ll] = 0.f;
                     }
                     newBurningCell.meanFirelineIntensity = 0.0;
                     burningCellInformationVector.push_back(newBurningCell);
                     numberOfCellsBurning++;
+                    statistics.numberOfCellsIgnited++;
             }
         }
     }
 }
 
 void
-Fire::initiatePrescribedBurning()
+Fire::initiatePrescribedBurning(LandscapeInterface *landscape, const IgnitionPattern &pattern)
 {
-    //check year for ignition of prescribed fires (fire frequency)
-    //check for ignition within the respective month
-    //get fire weather suited for prescribed burning
-    // if unsuited recalculate fire weather until suited conditions are received or
-    // limit is reached. Limit is given by probability for month. (1=30, 0.5 =15 ...)
-    //get camp identification for ignition
-    //depending on wind direction ignite camps border to receive specified fire type
+    resetFire();
+
+    //all vertices are lit in the same instant, before the fire spreads from any of them
+    for(const IgnitionVertex &vertex : pattern.getVertices()){
+        igniteVertex(landscape, vertex.u, vertex.v);
+    }
 }
 
 
@@ -1,11 +1,14 @@
 #ifndef WILDLAND_FIRESIM_FIRE_H
 #define WILDLAND_FIRESIM_FIRE_H
 
+#include <cstddef>
 #include <random>
 #include <math.h>
 #include <vector>
+#include <algorithm>
 #include "globals.h"
 #include "landscape_interface.h"
+#include "WFS_arena.h"
 #include "utility.h"
 
 namespace wildland_firesim {
@@ -17,6 +20,25 @@ struct FireWeatherVariables {
     float temperature;
 };
 
+constexpr int CellInternSpreadDirectionsCount = 3;
+
+//fuel load (g/m^2) a grass cell needs to be ignited by a wild fire
+constexpr float MinimumIgnitionFuelLoad = 200.f;
+
+class IgnitionPattern;
+class TaskScheduler;
+
+/*!
+ * \brief The FireStatistics struct
+ * summarizes a fire. Intensities are the mean fireline intensities of cells in kJ/s/m.
+ */
+struct FireStatistics {
+    int numberOfCellsIgnited = 0;
+    int numberOfCellsBurnedOut = 0;
+    float maximumFirelineIntensity = 0.f;
+    double sumOfFirelineIntensity = 0.0;
+};
+
 /*!
  * \brief The Fire class
  * contains all functions and variables required for the simulation of fire spread within the supplied
@@ -24,8 +46,51 @@ struct FireWeatherVariables {
  */
 class Fire
 {
+    friend class FireBenchmark;
+    friend class Checkpoint;
+    friend class BitSlicedEnsemble;
+
 public:
     Fire();
+    /*!
+     * \brief setFireWeather
+     * sets the fire weather used by the spread kernel. Each call starts a new weather epoch, so the
+     * cached rates of spread of the burning cells are recalculated once at their next update instead
+     * of in every timestep.
+     * \param weather
+     */
+    void setFireWeather(const FireWeatherVariables &weather);
+    /*!
+     * \brief setRandomStream
+     * sets the stream used for the stochastic parts of the fire, e.g. to run independent fires in
+     * parallel. The global stream is used by default.
+     * \param random
+     */
+    void setRandomStream(utility::RandomStream *random);
+    utility::RandomStream *getRandomStream() const noexcept;
+    /*!
+     * \brief setTaskScheduler
+     * lets the threads of the scheduler share the spread within cells of large fires. The fire is the
+     * same as without a scheduler. None is set by default.
+     * \param scheduler
+     */
+    void setTaskScheduler(TaskScheduler *scheduler);
+    /*!
+     * \brief setParallelSpreadMinimumCells
+     * sets the number of burning cells from which the spread within cells is shared by the threads of
+     * the scheduler, in pieces of a quarter of it. 8192 by default.
+     * \param cells
+     */
+    void setParallelSpreadMinimumCells(std::size_t cells);
+    /*!
+     * \brief setFrontSortInterval
+     * sorts the burning cells by their position in the storage of the landscape (see
+     * LandscapeInterface::getCellIndex) every given number of timesteps, so the cells and their
+     * neighbours are visited in memory order. The fire then draws its random numbers in another
+     * order than an unsorted fire. 0, the default, never sorts.
+     * \param timesteps
+     */
+    void setFrontSortInterval(int timesteps);
     /*!
      * \brief spreadFire
      * is a function to simulate fire spread within one timestep. The fire spread algorithm iterates over each cell
@@ -36,21 +101,39 @@ public:
      * out and fire effects on the vegetation in the respective are applied.
      * Each ignited point fire source tries to ignite the cells sharing the vertex and calculates its burn
      * status with the remaining time at the particular point fire source.
+     * The fire weather of the current epoch is used (see setFireWeather).
      * \param landscape
-     * \param weather
      * \param timestepLength
      */
-    void spreadFire(LandscapeInterface *landscape, const FireWeatherVariables &weather, int timestepLength);
+    void spreadFire(LandscapeInterface *landscape, int timestepLength);
     /*!
      * \brief fire::initiateWildFire
      * Function to set a point ignition source at a random cell vertex within the model landscape. Then the
      * cells of the vegetation type "grass" and a minimum fuel load sharing this vertex are ignited according
-     * to the initial ignition probability.
+     * to the initial ignition probability under the fire weather of the current epoch.
      * \param landscape
      */
-    void initiateWildFire(LandscapeInterface *landscape, const FireWeatherVariables &weather);
+    void initiateWildFire(LandscapeInterface *landscape);
 
-    void initiatePrescribedBurning();
+    /*!
+     * \brief initiateWildFire
+     * tries to ignite the cells sharing the given vertex like a wild fire, e.g. a vertex drawn by an
+     * IgnitionSampler.
+     * \param landscape
+     * \param u
+     * \param v
+     */
+    void initiateWildFire(LandscapeInterface *landscape, int u, int v);
+
+    /*!
+     * \brief initiatePrescribedBurning
+     * lights all vertices of an ignition pattern at once, e.g. the ignition lines of a prescribed
+     * burn. As with setIgnitionPoint, the grass cells sharing a vertex are ignited; a cell shared
+     * by several vertices is ignited from the first of them.
+     * \param landscape
+     * \param pattern
+     */
+    void initiatePrescribedBurning(LandscapeInterface *landscape, const IgnitionPattern &pattern);
 
     /*!
      * \brief setCenteredIgnitionPoint
@@ -60,6 +143,16 @@ public:
      */
     void setCenteredIgnitionPoint(LandscapeInterface *landscape);
 
+    /*!
+     * \brief setIgnitionPoint
+     * ignites the grass cells sharing the given vertex. Vertex (u, v) is the lower left corner of
+     * cell (u, v).
+     * \param landscape
+     * \param u
+     * \param v
+     */
+    void setIgnitionPoint(LandscapeInterface *landscape, int u, int v);
+
     /*!
      * \brief The burningCellInformation struct
      * holds information of burning cells required for the spread simulation.
@@ -70,8 +163,12 @@ public:
         int uCoordSource;
         int vCoordSource;
         float meanFirelineIntensity;
-        std::vector<float> burnStatus;
-        std::vector<int> spreadDirection;
+        float burnStatus[CellInternSpreadDirectionsCount];
+        int spreadDirection[CellInternSpreadDirectionsCount];
+        //rate of spread and fireline intensity per spread direction, valid within weatherEpoch
+        float rateOfSpread[CellInternSpreadDirectionsCount];
+        float firelineIntensity[CellInternSpreadDirectionsCount];
+        int weatherEpoch;
     };
 
     std::vector<burningCellInformation> burningCellInformationVector;
@@ -79,9 +176,60 @@ public:
     float distance_to_cell_boundary[3];
     int numberOfCellsBurning;
 
+    FireStatistics statistics;
+
+    /*!
+     * \brief getTouchedBounds
+     * \return box around the cells ignited since the fire was started, empty if none. Cells outside
+     * of it are as the fire found them.
+     */
+    const CellBounds &getTouchedBounds() const noexcept;
+
 private:
     int heatYield = 17000;
 
+    FireWeatherVariables m_weather;
+    int m_weatherEpoch;
+    utility::RandomStream *m_random;
+    CellBounds m_touchedBounds;
+    int m_frontSortInterval;
+    int m_timestepsSinceFrontSort;
+    TaskScheduler *m_scheduler;
+    std::size_t m_parallelSpreadMinimumCells;
+    //buffers needed within a timestep only, released at the begin of the next one
+    MonotonicArena m_spreadArena;
+
+    /*!
+     * \brief resetFire
+     * removes all burning cells and statistics before a fire is ignited.
+     */
+    void resetFire();
+
+    /*!
+     * \brief sortFront
+     * sorts the burning cells by their storage index in the landscape.
+     */
+    void sortFront(const LandscapeInterface *landscape);
+
+    /*!
+     * \brief igniteVertex
+     * ignites the unburned grass cells sharing a vertex.
+     * \param landscape
+     * \param u
+     * \param v
+     */
+    void igniteVertex(LandscapeInterface *landscape, int u, int v);
+
+    /*!
+     * \brief igniteWildFireAtVertex
+     * ignites each grass cell with the minimum fuel sharing a vertex with the initial ignition
+     * probability.
+     * \param landscape
+     * \param u
+     * \param v
+     */
+    void igniteWildFireAtVertex(LandscapeInterface *landscape, int u, int v);
+
     struct pointFireSourceInformation{
         int uCoord;
         int vCoord;
@@ -89,6 +237,54 @@ private:
         float fireIntensity;
     };
 
+    //point fire sources of the current timestep, in m_spreadArena
+    pointFireSourceInformation *pointFireSources;
+    size_t numberOfPointFireSources;
+
+    /*!
+     * \brief spreadWithinCells
+     * updates the burn status of each burning cell and appends a point fire source for each vertex
+     * reached by the fire.
+     * \param landscape
+     * \param timestepLength
+     */
+    void spreadWithinCells(LandscapeInterface *landscape, int timestepLength);
+
+    /*!
+     * \brief spreadWithinCell
+     * updates the burn status of a burning cell.
+     * \param burningCell
+     * \param landscape
+     * \param timestepLength
+     * \param sources receives the point fire sources of the vertices reached
+     * \return number of point fire sources
+     */
+    int spreadWithinCell(burningCellInformation &burningCell, const LandscapeInterface *landscape,
+                         int timestepLength, pointFireSourceInformation *sources);
+
+    /*!
+     * \brief burnOutCells
+     * removes cells whose vertices are all reached or whose fire is too weak from the burning cells.
+     * \param landscape
+     */
+    void burnOutCells(LandscapeInterface *landscape);
+
+    /*!
+     * \brief igniteCells
+     * tries to ignite the unburned cells sharing a vertex with each point fire source.
+     * \param landscape
+     */
+    void igniteCells(LandscapeInterface *landscape);
+
+    /*!
+     * \brief updateSpreadCache
+     * calculates rate of spread and fireline intensity of each spread direction of a burning cell
+     * under the fire weather of the current epoch.
+     * \param burningCell
+     * \param cell
+     */
+    void updateSpreadCache(burningCellInformation &burningCell, const Cell *cell);
+
     /*!
      * \brief calculateHeadFireRateOfSpread
      * Calculation of the head fire rate of spread in m/s after a semi-empirical model
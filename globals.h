@@ -1,6 +1,8 @@
 #ifndef WILDLAND_FIRESIM_GLOBALS_H
 #define WILDLAND_FIRESIM_GLOBALS_H
 
+#include <cstdint>
+
 namespace wildland_firesim {
 
 constexpr float Pi = 3.14159265358979323846264338327950288419716939937510f;
@@ -27,7 +29,7 @@ enum class VegetationType {
     NonFlammable
 };
 
-enum class CellState {
+enum class CellState : std::uint8_t {
     Unburned,
     Burning,
     BurnedOut
@@ -1,6 +1,7 @@
 #ifndef LANDSCAPE_INTERFACE_H
 #define LANDSCAPE_INTERFACE_H
 
+#include <cstddef>
 #include "cell.h"
 
 namespace wildland_firesim {
@@ -36,12 +37,133 @@ public:
      */
     virtual Cell *getCellInformation(int x, int y) = 0;
 
+    /*!
+     * \brief getCellInformation
+     * gives read-only access to a cell, e.g. for output. Landscapes which create or copy cells on
+     * access override it to avoid that.
+     * \param x
+     * \param y
+     * \return
+     */
+    virtual const Cell *getCellInformation(int x, int y) const
+    {
+        return const_cast<LandscapeInterface *>(this)->getCellInformation(x, y);
+    }
+
     /*!
      * \brief getCellSize
      * \return
      */
     virtual int getCellSize() const noexcept = 0;
 
+    /*!
+     * \brief getCellIndex
+     * gives the position of a cell in the storage of the landscape, e.g. to visit cells in the
+     * order they are stored. Row by row unless the landscape stores its cells otherwise.
+     * \param x
+     * \param y
+     * \return
+     */
+    virtual std::size_t getCellIndex(int x, int y) const noexcept
+    {
+        return static_cast<std::size_t>(y) * static_cast<std::size_t>(getWidth()) + static_cast<std::size_t>(x);
+    }
+
+    /*!
+     * \brief getStateEpoch
+     * \return epoch the cell states of the current fire are stamped with
+     */
+    std::uint16_t getStateEpoch() const noexcept
+    {
+        return m_stateEpoch;
+    }
+
+    /*!
+     * \brief resetCellStates
+     * makes all cells unburned for the next fire by starting a new state epoch. The cells are only
+     * visited when the epoch wraps around, so the reset does not depend on the size of the landscape.
+     */
+    void resetCellStates()
+    {
+        m_stateEpoch++;
+        if(m_stateEpoch == 0){
+            resetAllCellStates();
+        }
+    }
+
+protected:
+    /*!
+     * \brief resetAllCellStates
+     * makes the cells unburned in the current epoch when the epoch wrapped around, as states stamped
+     * 65536 fires ago would read as current. Landscapes which create cells on access only reset the
+     * cells they created.
+     */
+    virtual void resetAllCellStates()
+    {
+        for(int y = 0; y < getHeight(); y++)
+            for(int x = 0; x < getWidth(); x++){
+                getCellInformation(x, y)->setState(CellState::Unburned, m_stateEpoch);
+            }
+    }
+
+private:
+    std::uint16_t m_stateEpoch = 0;
+};
+
+/*!
+ * \brief The CellBounds struct
+ * inclusive bounding box of cells of a landscape; empty if minX > maxX.
+ */
+struct CellBounds {
+    int minX;
+    int minY;
+    int maxX;
+    int maxY;
+
+    bool empty() const noexcept
+    {
+        return minX > maxX;
+    }
+
+    /*!
+     * \brief include
+     * extends the box to cover the cell as well.
+     * \param x
+     * \param y
+     */
+    void include(int x, int y) noexcept
+    {
+        if(empty()){
+            *this = CellBounds{x, y, x, y};
+            return;
+        }
+        if(x < minX) minX = x;
+        if(x > maxX) maxX = x;
+        if(y < minY) minY = y;
+        if(y > maxY) maxY = y;
+    }
+
+    /*!
+     * \brief include
+     * extends the box to cover the other one as well.
+     * \param other
+     */
+    void include(const CellBounds &other) noexcept
+    {
+        if(other.empty()) return;
+        include(other.minX, other.minY);
+        include(other.maxX, other.maxY);
+    }
+
+    static CellBounds none() noexcept
+    {
+        return CellBounds{0, 0, -1, -1};
+    }
+
+    static CellBounds all(const LandscapeInterface &landscape) noexcept
+    {
+        return CellBounds{0, 0, landscape.getWidth() - 1, landscape.getHeight() - 1};
+    }
 };
 
 }  // namespace wildland_firesim
@@ -1,12 +1,11 @@
 #include <clocale>
 #include <cstdio>
 #include <cstdlib>
+#include <cstring>
+#include <thread>
 
-#include "simulation.h"
-#include "WFS_landscape.h"
-#include "WFS_output.h"
-#include "fire.h"
-#include "WFS_fireweather.h"
+#include "safim_study.h"
+#include "WFS_tracing.h"
 
 /*! \mainpage South African Savanna Fire Model
  * Fire is an important driver of vegetation dynamics in savanna ecosystems, yet often strongly
@@ -32,17 +31,41 @@ static const char *progname = nullptr;
 static const char *landscapeFile = nullptr;
 static const char *month = nullptr;
 static const char *weatherFile = nullptr;
+static const char *weatherSeriesFile = nullptr;
+static const char *weatherBankFile = nullptr;
+static const char *scenarioFile = nullptr;
+static const char *landscapeCacheDirectory = nullptr;
+static const char *traceFile = nullptr;
+static const char *serverEndpoint = nullptr;
+static const char *checkpointFile = nullptr;
+static const char *resumeFile = nullptr;
+static const char *ignition = nullptr;
 
 static const char *fixedWeatherFile = "fixed_fireweather.txt";
 
 static int timestepLength = 15;
 static int maximalFireDuration = 5400;
 static int numberOfRuns = 1;
+static int numberOfWeatherTrajectories = 0;
+static int checkpointInterval = 240;
+static int decisionHour = -1;
+static float ensemblePrecision = 0.f;
+static int minimumComponentSize = 0;
+static unsigned int seed = 42;
+static int numberOfThreads = static_cast<int>(std::thread::hardware_concurrency());
 
 // import landscape option - uses files in folder
 static bool importLandscape = false;
 static bool simulateFireWeather = false;
 static bool centeredIgnitionPoint = false;
+static bool sampledIgnitionPoint = false;
+static bool sparseOutput = false;
+static bool bitSlicedEnsemble = false;
+static CellLayout cellLayout = CellLayout::RowMajor;
+static int frontSortInterval = 0;
+static int preparationThreads = 1;
+static int writerThreads = 1;
+static bool pipelineSummary = false;
 
 [[noreturn]] static void
 usage()
@@ -57,10 +80,31 @@ usage()
     fprintf(stderr, "\t-w <weather-file>\tThe CSV file containing the meteorological parameters.\n");
     fprintf(stderr, "\t-m <month>\tThe month for which the fire weather is simulated.\n");
     fprintf(stderr, "\t-b <fixed-weather-file-name>\tFile name for parameter list.\n");
+    fprintf(stderr, "\t-e <weather-series-file>\tCSV file containing hourly fire weather.\n");
     fprintf(stderr, "\t-t <timestep-length>\tLength of timesteps.\n");
     fprintf(stderr, "\t-d <maximal-fire-duration>\tMaximal duration of the fire simulation.\n");
     fprintf(stderr, "\t-r <number-of-runs>\tNumber of model runs.\n");
+    fprintf(stderr, "\t-B\tWrite only the burned cells of each run instead of burn map and burn data.\n");
+    fprintf(stderr, "\t-P <precision>\tStop the runs (at most -r) once burn probabilities and burned area are this precise.\n");
+    fprintf(stderr, "\t-E\tBurn the -r runs on one landscape under fixed weather, 64 at once (experimental).\n");
     fprintf(stderr, "\t-c\tCentered ignition point.\n");
+    fprintf(stderr, "\t-S\tSpread the ignition vertices of the runs evenly over the flammable vertices.\n");
+    fprintf(stderr, "\t-C <minimum-cells>\tLeave out sampled ignition vertices in flammable patches of fewer cells.\n");
+    fprintf(stderr, "\t-z <ignition>\tIgnition pattern file, or items like \"point,u,v;line,u,v,u,v\" lit at once.\n");
+    fprintf(stderr, "\t-n <number-of-trajectories>\tPrecompute weather trajectories per month.\n");
+    fprintf(stderr, "\t-k <weather-bank-file>\tLoad weather trajectories from file or save them to it.\n");
+    fprintf(stderr, "\t-g <seed>\tSeed for precomputed random inputs.\n");
+    fprintf(stderr, "\t-j <number-of-threads>\tNumber of worker threads.\n");
+    fprintf(stderr, "\t-x <scenario-file>\tBurn the landscape under each fixed fire weather scenario.\n");
+    fprintf(stderr, "\t-y <cache-directory>\tDirectory to cache generated landscapes in.\n");
+    fprintf(stderr, "\t-Z <sort-interval>\tStore landscapes in Z-order tiles, sort the burning cells every <sort-interval> timesteps (0: never).\n");
+    fprintf(stderr, "\t-W <landscape-threads>,<output-threads>\tThreads preparing landscapes and writing outputs of the runs, writes \"pipeline_summary.csv\".\n");
+    fprintf(stderr, "\t-p <trace-file>\tWrite a timeline of the simulation (Chrome trace-event JSON).\n");
+    fprintf(stderr, "\t-u <socket-path>\tServe fire jobs on a Unix domain socket, or on standard input and output if \"-\".\n");
+    fprintf(stderr, "\t-f <checkpoint-file>\tWrite a checkpoint of the fire in progress to the file.\n");
+    fprintf(stderr, "\t-i <checkpoint-interval>\tTimesteps between two checkpoints (default 240).\n");
+    fprintf(stderr, "\t-o <checkpoint-file>\tResume the simulation from a checkpoint.\n");
+    fprintf(stderr, "\t-q <decision-hour>\tBranch the fire into each weather trajectory at the given hour.\n");
 
     exit(1);
 }
@@ -104,6 +148,11 @@ parseArguments(int argc, char *argv[])
             argc--;
             argv++;
             break;
+        case 'e':
+            weatherSeriesFile = argv[2];
+            argc--;
+            argv++;
+            break;
         case 't':
             timestepLength = atoi(argv[2]);
             argc--;
@@ -122,12 +171,162 @@ parseArguments(int argc, char *argv[])
         case 'c':
             centeredIgnitionPoint = true;
             break;
+        case 'n':
+            numberOfWeatherTrajectories = atoi(argv[2]);
+            argc--;
+            argv++;
+            break;
+        case 'k':
+            weatherBankFile = argv[2];
+            argc--;
+            argv++;
+            break;
+        case 'g':
+            seed = static_cast<unsigned int>(strtoul(argv[2], nullptr, 10));
+            argc--;
+            argv++;
+            break;
+        case 'j':
+            numberOfThreads = atoi(argv[2]);
+            argc--;
+            argv++;
+            break;
+        case 'x':
+            scenarioFile = argv[2];
+            argc--;
+            argv++;
+            break;
+        case 'y':
+            landscapeCacheDirectory = argv[2];
+            argc--;
+            argv++;
+            break;
+        case 'p':
+            traceFile = argv[2];
+            argc--;
+            argv++;
+            break;
+        case 'u':
+            serverEndpoint = argv[2];
+            argc--;
+            argv++;
+            break;
+        case 'f':
+            checkpointFile = argv[2];
+            argc--;
+            argv++;
+            break;
+        case 'i':
+            checkpointInterval = atoi(argv[2]);
+            argc--;
+            argv++;
+            break;
+        case 'o':
+            resumeFile = argv[2];
+            argc--;
+            argv++;
+            break;
+        case 'q':
+            decisionHour = atoi(argv[2]);
+            argc--;
+            argv++;
+            break;
+        case 'z':
+            ignition = argv[2];
+            argc--;
+            argv++;
+            break;
+        case 'P':
+            ensemblePrecision = static_cast<float>(atof(argv[2]));
+            argc--;
+            argv++;
+            break;
+        case 'S':
+            sampledIgnitionPoint = true;
+            break;
+        case 'B':
+            sparseOutput = true;
+            break;
+        case 'C':
+            minimumComponentSize = atoi(argv[2]);
+            argc--;
+            argv++;
+            break;
+        case 'E':
+            bitSlicedEnsemble = true;
+            break;
+        case 'Z':
+            cellLayout = CellLayout::ZOrderTiles;
+            frontSortInterval = atoi(argv[2]);
+            argc--;
+            argv++;
+            break;
+        case 'W':
+            if (sscanf(argv[2], "%d,%d", &preparationThreads, &writerThreads) != 2)
+                usage();
+            pipelineSummary = true;
+            argc--;
+            argv++;
+            break;
         }
         argc--;
         argv++;
     }
 }
 
+/*!
+ * \brief studySettings
+ * \return the settings of the study given by the options
+ */
+static safim::StudySettings
+studySettings()
+{
+    safim::StudySettings settings;
+    settings.importLandscape = importLandscape;
+    if (landscapeFile)
+        settings.landscapeParameterFile = landscapeFile;
+    if (landscapeCacheDirectory)
+        settings.landscapeCacheDirectory = landscapeCacheDirectory;
+    settings.cellLayout = cellLayout;
+
+    settings.simulateFireWeather = simulateFireWeather;
+    if (weatherFile)
+        settings.meteorologicalParameterFile = weatherFile;
+    if (month)
+        settings.month = month;
+    if (weatherSeriesFile)
+        settings.weatherSeriesFile = weatherSeriesFile;
+    settings.fixedWeatherFile = fixedWeatherFile;
+    settings.useWeatherBank = numberOfWeatherTrajectories > 0 || weatherBankFile;
+    settings.numberOfWeatherTrajectories = numberOfWeatherTrajectories;
+    if (weatherBankFile)
+        settings.weatherBankFile = weatherBankFile;
+
+    settings.timestepLength = timestepLength;
+    settings.maximalFireDuration = maximalFireDuration;
+    settings.frontSortInterval = frontSortInterval;
+    settings.centeredIgnitionPoint = centeredIgnitionPoint;
+    settings.sampledIgnitionPoint = sampledIgnitionPoint;
+    settings.minimumComponentSize = minimumComponentSize;
+    if (ignition)
+        settings.ignition = ignition;
+
+    settings.numberOfRuns = numberOfRuns;
+    settings.seed = seed;
+    settings.numberOfThreads = numberOfThreads;
+    settings.sparseOutput = sparseOutput;
+    settings.ensemblePrecision = ensemblePrecision;
+    settings.preparationThreads = preparationThreads;
+    settings.writerThreads = writerThreads;
+    settings.pipelineSummary = pipelineSummary;
+    if (checkpointFile)
+        settings.checkpointFile = checkpointFile;
+    settings.checkpointInterval = checkpointInterval;
+    if (resumeFile)
+        settings.resumeFile = resumeFile;
+    return settings;
+}
+
 int main(int argc, char *argv[] )
 {
     parseArguments(argc, argv);
@@ -151,75 +350,130 @@ int main(int argc, char *argv[] )
             fprintf(stderr, "error: month for fire weather simulation has to be specified\n");
             exit(1);
         }
+        if (weatherSeriesFile) {
+            fprintf(stderr, "error: fire weather is simulated, using a weather series is invalid\n");
+            exit(1);
+        }
+    } else if (numberOfWeatherTrajectories > 0 || weatherBankFile) {
+        fprintf(stderr, "error: weather trajectories require the simulation of fire weather\n");
+        exit(1);
+    }
+    if (scenarioFile && (simulateFireWeather || weatherSeriesFile)) {
+        fprintf(stderr, "error: scenarios use fixed fire weather, simulating or importing weather is invalid\n");
+        exit(1);
+    }
+    if (serverEndpoint && (scenarioFile || weatherSeriesFile)) {
+        fprintf(stderr, "error: jobs are served with fixed or precomputed weather, scenarios and weather series are invalid\n");
+        exit(1);
+    }
+    if (serverEndpoint && simulateFireWeather && numberOfWeatherTrajectories == 0 && !weatherBankFile) {
+        fprintf(stderr, "error: serving jobs with simulated fire weather requires weather trajectories\n");
+        exit(1);
+    }
+    if ((checkpointFile || resumeFile) && (scenarioFile || serverEndpoint)) {
+        fprintf(stderr, "error: checkpoints are only written by simulation runs, not by scenarios or jobs\n");
+        exit(1);
+    }
+    if (decisionHour >= 0 && (numberOfWeatherTrajectories == 0 && !weatherBankFile)) {
+        fprintf(stderr, "error: branching the fire requires weather trajectories\n");
+        exit(1);
+    }
+    if (decisionHour >= 0 && (scenarioFile || serverEndpoint || checkpointFile || resumeFile)) {
+        fprintf(stderr, "error: branches can not be combined with scenarios, jobs or checkpoints\n");
+        exit(1);
+    }
+    if (ignition && centeredIgnitionPoint) {
+        fprintf(stderr, "error: either an ignition pattern or the centered ignition point can be used\n");
+        exit(1);
+    }
+    if (ignition && serverEndpoint) {
+        fprintf(stderr, "error: jobs choose their ignition vertex, an ignition pattern is invalid\n");
+        exit(1);
+    }
+    if (sampledIgnitionPoint && (ignition || centeredIgnitionPoint)) {
+        fprintf(stderr, "error: sampled ignition vertices replace the random one, not a given ignition\n");
+        exit(1);
+    }
+    if (sampledIgnitionPoint && (scenarioFile || serverEndpoint || decisionHour >= 0 || resumeFile)) {
+        fprintf(stderr, "error: sampled ignition vertices only apply to runs, not to scenarios, jobs, branches or resumed runs\n");
+        exit(1);
+    }
+    if (sparseOutput && (scenarioFile || serverEndpoint || decisionHour >= 0)) {
+        fprintf(stderr, "error: sparse output only applies to runs, not to scenarios, jobs or branches\n");
+        exit(1);
     }
+    if (minimumComponentSize != 0 && (!sampledIgnitionPoint || minimumComponentSize < 0)) {
+        fprintf(stderr, "error: the minimum size of flammable patches requires sampled ignition vertices and must be positive\n");
+        exit(1);
+    }
+    if (bitSlicedEnsemble && (simulateFireWeather || weatherSeriesFile || scenarioFile || serverEndpoint ||
+                              decisionHour >= 0 || checkpointFile || resumeFile)) {
+        fprintf(stderr, "error: the bit-sliced ensemble needs fixed fire weather and can not be combined with scenarios, jobs, branches or checkpoints\n");
+        exit(1);
+    }
+    if (bitSlicedEnsemble && (ignition || sampledIgnitionPoint || ensemblePrecision > 0.f || sparseOutput)) {
+        fprintf(stderr, "error: the bit-sliced ensemble only ignites random or centered vertices and writes its own output\n");
+        exit(1);
+    }
+    if (ensemblePrecision < 0.f || ensemblePrecision >= 1.f) {
+        fprintf(stderr, "error: the precision of the ensemble must be between 0 and 1\n");
+        exit(1);
+    }
+    if (ensemblePrecision > 0.f && (scenarioFile || serverEndpoint || decisionHour >= 0 || resumeFile)) {
+        fprintf(stderr, "error: the ensemble precision only applies to runs, not to scenarios, jobs, branches or resumed runs\n");
+        exit(1);
+    }
+    if (preparationThreads < 1 || writerThreads < 1) {
+        fprintf(stderr, "error: the stages of the runs need at least one thread each\n");
+        exit(1);
+    }
+    if (pipelineSummary && (scenarioFile || serverEndpoint || decisionHour >= 0 || bitSlicedEnsemble)) {
+        fprintf(stderr, "error: the threads of the run stages only apply to runs, not to scenarios, jobs, branches or the bit-sliced ensemble\n");
+        exit(1);
+    }
+    if (frontSortInterval < 0) {
+        fprintf(stderr, "error: the interval of sorting the burning cells must not be negative\n");
+        exit(1);
+    }
+    if (checkpointFile && checkpointInterval < 1) {
+        fprintf(stderr, "error: the checkpoint interval must be at least one timestep\n");
+        exit(1);
+    }
+    if (numberOfThreads < 1)
+        numberOfThreads = 1;
+    if (traceFile)
+        tracing::start();
 
+    //results served on standard output must not be mixed with the settings
+    FILE *info = serverEndpoint && strcmp(serverEndpoint, "-") == 0 ? stderr : stdout;
     if (landscapeFile != nullptr)
-        printf("landscapeFile=%s\n", landscapeFile);
+        fprintf(info, "landscapeFile=%s\n", landscapeFile);
     if (month != nullptr)
-        printf("month=%s\n", month);
+        fprintf(info, "month=%s\n", month);
     if (weatherFile != nullptr)
-        printf("weatherFile=%s\n", weatherFile);
-    printf("fixedWeatherFile=%s\n", fixedWeatherFile);
-
-    //create instance of simulation class
-    Simulation fireSimulation;
-    //initialize fire weather
-    FireWeather weatherSimulation;
-    //initialize output
-    Output output;
-
-    //setup simulation
-    //general parameters
-    fireSimulation.timestepLength = timestepLength;
-    fireSimulation.maxFireDuration = maximalFireDuration;
-    fireSimulation.numberOfRuns = numberOfRuns;
-
-    //import landscape option - uses files in folder
-    fireSimulation.importLandscape = importLandscape;
-
-    //enquire name of file for landscape creation
-    if(!importLandscape){
-        fireSimulation.nameOfLandscapeParameterFile = landscapeFile;
-    }
-
-    //specification of ignition location
-    fireSimulation.igniteCentralVertex = centeredIgnitionPoint;
+        fprintf(info, "weatherFile=%s\n", weatherFile);
+    if (weatherSeriesFile != nullptr)
+        fprintf(info, "weatherSeriesFile=%s\n", weatherSeriesFile);
+    else if (scenarioFile != nullptr)
+        fprintf(info, "scenarioFile=%s\n", scenarioFile);
+    else
+        fprintf(info, "fixedWeatherFile=%s\n", fixedWeatherFile);
 
-    //specification fire weather simulation
-    fireSimulation.simulateFireWeather = simulateFireWeather;
-    auto weather = FireWeatherVariables{};
-
-    if (simulateFireWeather) {
-        weatherSimulation.importMeteorologicalParameter(weatherFile);
-        fireSimulation.whichMonth = fireSimulation.stringToMonth(month);
-    } else {
-       weatherSimulation.getFixedFireWeatherParameter(fixedWeatherFile, &weather);
-    }
-
-    //start simulation(s) and data log
-    for (int i = 0; i < fireSimulation.numberOfRuns; i++) {
-        // create model landscape
-        WFS_Landscape modelLandscape;
-        if (fireSimulation.importLandscape){
-            modelLandscape.importLandscapeFromFile();
-        } else {
-            modelLandscape.generateLandscapeFromFile(fireSimulation.nameOfLandscapeParameterFile);
-        }
-        //vegetation data before burn
-        //output.writeVegetationMapToASCII(modelLandscape, output.setfileName("vegetation_map", ".asc", i));
-        //output.writeVegetationDataToCSV(modelLandscape, output.setfileName("vegetation_data", ".csv", i));
-
-        //fire simulation
-        fireSimulation.runSimulation(&modelLandscape, weather, weatherSimulation, &output);
-
-        //creating simulation output
-        output.writeBurnMapToASCII(modelLandscape, output.setfileName("burn_map", ".asc", i ));
-        output.writeBurnDataToCSV(modelLandscape, fireSimulation.fire, output.setfileName("burndata", ".csv", i));
-        if(fireSimulation.simulateFireWeather){
-            output.writeFireWeatherDataToCSV(output.weatherData, output.setfileName("weatherdata", ".csv", i ) );
-            output.weatherData.clear();
-        }
-    }
+    //the options select one of the studies of the library
+    safim::Study study{studySettings()};
+    int status = 0;
+    if (scenarioFile)
+        study.runScenarios(scenarioFile);
+    else if (decisionHour >= 0)
+        study.runBranches(decisionHour);
+    else if (serverEndpoint)
+        status = study.serveJobs(serverEndpoint) ? 0 : 1;
+    else if (bitSlicedEnsemble)
+        study.runBitSlicedEnsemble();
+    else
+        study.runEnsemble();
+    if (traceFile)
+        tracing::writeTrace(traceFile);
 
-    return 0;
+    return status;
 }
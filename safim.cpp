@@ -0,0 +1,132 @@
+#include "safim.h"
+#include "simulation.h"
+#include "WFS_weathertimeline.h"
+
+namespace safim {
+namespace {
+
+using namespace ::wildland_firesim;
+
+/*!
+ * \brief burn
+ * runs the fire and fills all of the result except the burn map.
+ */
+void
+burn(LandscapeInterface &landscape, const std::vector<Weather> &hourlyWeather, const FireSettings &settings,
+     const StepCallback &callback, FireResult *result)
+{
+    WILDLAND_ASSERT(!hourlyWeather.empty(), "fire weather is missing");
+
+    std::vector<FireWeatherVariables> weatherSeries;
+    for(const Weather &weather : hourlyWeather){
+        FireWeatherVariables variables;
+        variables.temperature = weather.temperature;
+        variables.relHumidity = weather.relHumidity;
+        variables.windSpeed = weather.windSpeed;
+        variables.windDirection = weather.windDirection;
+        weatherSeries.push_back(variables);
+    }
+    WeatherTimeline weatherTimeline;
+    weatherTimeline.setWeatherSeries(weatherSeries);
+
+    Simulation simulation;
+    simulation.timestepLength = settings.timestepLength;
+    simulation.maxFireDuration = settings.maximalFireDuration;
+    simulation.simulateFireWeather = false;
+    simulation.igniteCentralVertex = settings.ignition == Ignition::Centered;
+    simulation.igniteGivenVertex = settings.ignition == Ignition::Vertex;
+    simulation.ignitionU = settings.ignitionU;
+    simulation.ignitionV = settings.ignitionV;
+    if(settings.ignition == Ignition::Pattern){
+        WILDLAND_ASSERT(settings.ignitionPattern, "ignition pattern is missing");
+        simulation.ignitionPattern = settings.ignitionPattern;
+    }
+    utility::RandomStream random{settings.seed};
+    simulation.fire.setRandomStream(&random);
+
+    result->width = landscape.getWidth();
+    result->height = landscape.getHeight();
+    result->ignitionTimestep.assign(static_cast<size_t>(result->width) * result->height, -1);
+
+    const Fire &fire = simulation.fire;
+    int recordedIgnitions = 0;
+    simulation.timestepCallback = [&](int timestep, float durationOfBurn) {
+        //cells ignited within a timestep are the last ones appended to the burning cells
+        size_t ignitions = static_cast<size_t>(fire.statistics.numberOfCellsIgnited - recordedIgnitions);
+        recordedIgnitions = fire.statistics.numberOfCellsIgnited;
+        const auto &burningCells = fire.burningCellInformationVector;
+        for(size_t i = burningCells.size() - ignitions; i < burningCells.size(); i++){
+            result->ignitionTimestep[static_cast<size_t>(burningCells[i].yCoord) * result->width +
+                    burningCells[i].xCoord] = timestep;
+        }
+        result->timesteps = timestep;
+        if(!callback) return true;
+        StepInfo info;
+        info.timestep = timestep;
+        info.durationOfBurn = durationOfBurn;
+        info.numberOfCellsBurning = fire.numberOfCellsBurning;
+        info.numberOfCellsIgnited = fire.statistics.numberOfCellsIgnited;
+        info.numberOfCellsBurnedOut = fire.statistics.numberOfCellsBurnedOut;
+        return callback(info);
+    };
+
+    Output output;
+    simulation.runSimulation(&landscape, &weatherTimeline, &output);
+
+    const FireStatistics &statistics = fire.statistics;
+    result->duration = simulation.durationOfFire;
+    result->numberOfCellsIgnited = statistics.numberOfCellsIgnited;
+    result->numberOfCellsBurnedOut = statistics.numberOfCellsBurnedOut;
+    result->numberOfCellsBurning = fire.numberOfCellsBurning;
+    result->maximumFirelineIntensity = statistics.maximumFirelineIntensity;
+    result->meanFirelineIntensity = statistics.numberOfCellsBurnedOut > 0 ?
+                static_cast<float>(statistics.sumOfFirelineIntensity / statistics.numberOfCellsBurnedOut) : 0.f;
+}
+
+}
+
+FireResult
+runFire(const FuelRasters &fuel, const std::vector<Weather> &hourlyWeather, const FireSettings &settings,
+        const StepCallback &callback)
+{
+    RasterLandscape landscape{fuel};
+    return runFire(landscape, hourlyWeather, settings, callback);
+}
+
+FireResult
+runFire(RasterLandscape &landscape, const std::vector<Weather> &hourlyWeather, const FireSettings &settings,
+        const StepCallback &callback)
+{
+    landscape.reset();
+    FireResult result;
+    burn(landscape, hourlyWeather, settings, callback, &result);
+
+    //only cells accessed by the fire can have changed
+    result.burnMap.assign(static_cast<size_t>(result.width) * result.height,
+                          static_cast<std::uint8_t>(CellState::Unburned));
+    for(size_t i = 0; i < landscape.getNumberOfAccessedCells(); i++){
+        int x, y;
+        const Cell &cell = landscape.getAccessedCell(i, &x, &y);
+        result.burnMap[static_cast<size_t>(y) * result.width + x] = static_cast<std::uint8_t>(cell.getState(landscape.getStateEpoch()));
+    }
+    return result;
+}
+
+FireResult
+runFire(LandscapeInterface &landscape, const std::vector<Weather> &hourlyWeather, const FireSettings &settings,
+        const StepCallback &callback)
+{
+    FireResult result;
+    burn(landscape, hourlyWeather, settings, callback, &result);
+
+    result.burnMap.resize(static_cast<size_t>(result.width) * result.height);
+    for(int y = 0; y < result.height; y++){
+        for(int x = 0; x < result.width; x++){
+            result.burnMap[static_cast<size_t>(y) * result.width + x] =
+                    static_cast<std::uint8_t>(landscape.getCellInformation(x, y)->getState(landscape.getStateEpoch()));
+        }
+    }
+    return result;
+}
+
+}  // namespace safim
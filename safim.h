@@ -0,0 +1,125 @@
+#ifndef SAFIM_H
+#define SAFIM_H
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+#include "landscape_interface.h"
+#include "WFS_rasterlandscape.h"
+#include "WFS_ignition.h"
+
+/*!
+ * Programming interface of the safim library for embedding the fire model, e.g. into a vegetation
+ * model. Fuel is read directly from rasters of the host, weather is given in memory and results are
+ * returned in memory; no files are read or written. Hosts that need the individual parts of the
+ * model (landscape generation, fire weather simulation, output) use the wildland_firesim classes,
+ * the studies of the simulator working on files are in "safim_study.h".
+ */
+namespace safim {
+
+constexpr int ApiVersion = 1;
+
+using wildland_firesim::FuelRasters;
+using wildland_firesim::IgnitionPattern;
+using wildland_firesim::LandscapeInterface;
+using wildland_firesim::RasterLandscape;
+using wildland_firesim::RasterView;
+
+/*!
+ * \brief The Weather struct
+ * fire weather of one hour. The wind direction (1..8, 1 = north, clockwise) is the direction the wind
+ * is blowing to.
+ */
+struct Weather {
+    float temperature;  // °C
+    float relHumidity;  // %
+    float windSpeed;    // m/s
+    int windDirection;
+};
+
+enum class Ignition {
+    Random,   // random vertex drawn from the seeded stream
+    Centered, // central vertex of the landscape
+    Vertex,   // vertex (ignitionU, ignitionV) of FireSettings, the lower left corner of cell (u, v)
+    Pattern   // all vertices of ignitionPattern of FireSettings at once
+};
+
+struct FireSettings {
+    int timestepLength = 15;        // s
+    int maximalFireDuration = 5400; // timesteps
+    unsigned int seed = 42;
+    Ignition ignition = Ignition::Random;
+    int ignitionU = 0;
+    int ignitionV = 0;
+    const IgnitionPattern *ignitionPattern = nullptr;
+};
+
+/*!
+ * \brief The StepInfo struct
+ * state of the fire after the ignition (timestep 0) and after each timestep.
+ */
+struct StepInfo {
+    int timestep;
+    float durationOfBurn; // h
+    int numberOfCellsBurning;
+    int numberOfCellsIgnited;
+    int numberOfCellsBurnedOut;
+};
+
+/*!
+ * \brief StepCallback
+ * is called after the ignition and after each timestep; returning false stops the fire.
+ */
+using StepCallback = std::function<bool(const StepInfo &)>;
+
+/*!
+ * \brief The FireResult struct
+ * result rasters and summary of a fire. Rasters hold width * height values, the value of cell (x, y)
+ * is at y * width + x.
+ */
+struct FireResult {
+    int width = 0;
+    int height = 0;
+    std::vector<std::uint8_t> burnMap;  // 0 unburned, 1 burning, 2 burned out
+    std::vector<int> ignitionTimestep;  // -1 if not ignited
+    int timesteps = 0;
+    float duration = 0.f;               // h
+    int numberOfCellsIgnited = 0;
+    int numberOfCellsBurnedOut = 0;
+    int numberOfCellsBurning = 0;       // still burning at the end of the fire
+    float maximumFirelineIntensity = 0.f; // kJ/s/m
+    float meanFirelineIntensity = 0.f;    // of the burned-out cells
+};
+
+/*!
+ * \brief runFire
+ * burns the landscape described by the fuel rasters of the host. The rasters are not copied or
+ * modified. The last hour of the weather is kept if the fire outlasts it.
+ * \param fuel
+ * \param hourlyWeather at least one hour
+ * \param settings
+ * \param callback optional
+ * \return
+ */
+FireResult runFire(const FuelRasters &fuel, const std::vector<Weather> &hourlyWeather,
+                   const FireSettings &settings, const StepCallback &callback = StepCallback());
+
+/*!
+ * \brief runFire
+ * burns a landscape on fuel rasters that is reused for many fires, e.g. by a worker thread. The
+ * landscape is reset before the fire.
+ */
+FireResult runFire(RasterLandscape &landscape, const std::vector<Weather> &hourlyWeather,
+                   const FireSettings &settings, const StepCallback &callback = StepCallback());
+
+/*!
+ * \brief runFire
+ * burns a landscape of the host implementing LandscapeInterface. The cell states of the landscape
+ * are changed by the fire.
+ */
+FireResult runFire(LandscapeInterface &landscape, const std::vector<Weather> &hourlyWeather,
+                   const FireSettings &settings, const StepCallback &callback = StepCallback());
+
+}  // namespace safim
+
+#endif // SAFIM_H
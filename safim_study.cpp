@@ -0,0 +1,408 @@
+#include "safim_study.h"
+#include "safim.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <limits>
+#include <vector>
+#include "WFS_output.h"
+#include "WFS_sweep.h"
+#include "WFS_fork.h"
+#include "WFS_ensemble.h"
+#include "WFS_bitslice.h"
+#include "WFS_server.h"
+#include "WFS_checkpoint.h"
+#include "WFS_components.h"
+#include "WFS_pipeline.h"
+#include "WFS_profiling.h"
+#include "WFS_tracing.h"
+
+namespace safim {
+namespace {
+
+using namespace ::wildland_firesim;
+
+//stream of the sampled ignition vertices, apart from the streams 0, 1, ... of the landscapes of the runs
+constexpr unsigned int IgnitionSamplerStream = std::numeric_limits<unsigned int>::max();
+
+/*!
+ * \brief The RunSlot struct
+ * holds a run while it passes the pipeline of the runs.
+ */
+struct RunSlot {
+    WFS_Landscape landscape;
+    FlammableComponents flammableComponents;
+    Simulation simulation;
+    Output output;
+    //the imported landscape is read once per slot
+    bool imported = false;
+    IgnitionVertex ignitionVertex;
+    double ignitionWeight = 1.0;
+#ifdef WILDLAND_FIRESIM_PROFILING
+    profiling::RunProfile profile;
+#endif
+};
+
+}
+
+Study::Study(const StudySettings &settings) :
+    m_settings(settings),
+    m_scheduler(new TaskScheduler{settings.numberOfThreads}),
+    m_simulation(), m_ignitionPattern(), m_weatherSimulation(), m_weatherTimeline(), m_weatherBank()
+{
+    //general parameters
+    m_simulation.timestepLength = settings.timestepLength;
+    m_simulation.maxFireDuration = settings.maximalFireDuration;
+    m_simulation.numberOfRuns = settings.numberOfRuns;
+    m_simulation.fire.setFrontSortInterval(settings.frontSortInterval);
+    m_simulation.fire.setTaskScheduler(m_scheduler.get());
+
+    m_simulation.importLandscape = settings.importLandscape;
+    if(!settings.importLandscape){
+        m_simulation.nameOfLandscapeParameterFile = settings.landscapeParameterFile;
+    }
+
+    //specification of ignition location
+    m_simulation.igniteCentralVertex = settings.centeredIgnitionPoint;
+    if(!settings.ignition.empty()){
+        if(std::ifstream{settings.ignition}){
+            m_ignitionPattern.importFromFile(settings.ignition);
+        } else {
+            m_ignitionPattern.parse(settings.ignition);
+        }
+        m_simulation.ignitionPattern = &m_ignitionPattern;
+    }
+
+    m_simulation.simulateFireWeather = settings.simulateFireWeather;
+
+    if(!settings.checkpointFile.empty()){
+        m_simulation.checkpointInterval = settings.checkpointInterval;
+        m_simulation.checkpointFileName = settings.checkpointFile;
+    }
+}
+
+void
+Study::loadLandscape(WFS_Landscape *landscape, unsigned int seed) const
+{
+    landscape->setLayout(m_settings.cellLayout);
+    if(!m_settings.landscapeCacheDirectory.empty()){
+        landscape->setCacheDirectory(m_settings.landscapeCacheDirectory);
+    }
+    WILDLAND_TRACE_SPAN("landscapeLoad");
+    if(m_settings.importLandscape){
+        landscape->importLandscapeFromFile();
+    } else {
+        landscape->generateLandscapeFromFile(m_settings.landscapeParameterFile, seed, m_settings.numberOfThreads);
+    }
+}
+
+void
+Study::loadWeather()
+{
+    if(m_settings.simulateFireWeather){
+        m_weatherSimulation.importMeteorologicalParameter(m_settings.meteorologicalParameterFile);
+        m_simulation.whichMonth = m_simulation.stringToMonth(m_settings.month);
+        m_weatherTimeline.setWeatherSimulation(&m_weatherSimulation, m_simulation.whichMonth);
+        const std::string &bankFile = m_settings.weatherBankFile;
+        //one trajectory per run unless specified, long enough for the maximal fire duration
+        int numberOfTrajectories = m_settings.numberOfWeatherTrajectories > 0 ?
+                    m_settings.numberOfWeatherTrajectories : m_settings.numberOfRuns;
+        int numberOfHours = m_settings.maximalFireDuration * m_settings.timestepLength / (60 * 60) + 1;
+        if(m_settings.useWeatherBank && !bankFile.empty() && m_weatherBank.loadFromFile(bankFile)){
+            checkWeatherBank(numberOfTrajectories, numberOfHours);
+        } else if(m_settings.useWeatherBank){
+            m_weatherBank.generate(m_weatherSimulation, numberOfTrajectories, numberOfHours, m_settings.seed,
+                                   m_settings.numberOfThreads);
+            if(!bankFile.empty() && !m_weatherBank.saveToFile(bankFile)){
+                fprintf(stderr, "error: weather bank could not be written to %s\n", bankFile.c_str());
+                exit(1);
+            }
+        }
+    } else if(!m_settings.weatherSeriesFile.empty()){
+        m_weatherTimeline.importWeatherSeriesFromFile(m_settings.weatherSeriesFile);
+    } else {
+        auto weather = FireWeatherVariables{};
+        m_weatherSimulation.getFixedFireWeatherParameter(m_settings.fixedWeatherFile, &weather);
+        m_weatherTimeline.setFixedWeather(weather);
+    }
+}
+
+void
+Study::checkWeatherBank(int numberOfTrajectories, int numberOfHours) const
+{
+    //a bank simulated with other settings would silently replace the weather of the study
+    const char *fileName = m_settings.weatherBankFile.c_str();
+    if(m_weatherBank.getSeed() != m_settings.seed){
+        fprintf(stderr, "error: weather bank %s was simulated with seed %u, not %u\n", fileName,
+                m_weatherBank.getSeed(), m_settings.seed);
+        exit(1);
+    }
+    if(m_weatherBank.getParameterHash() != m_weatherSimulation.getParameterHash()){
+        fprintf(stderr, "error: weather bank %s was simulated with other meteorological parameters than %s\n",
+                fileName, m_settings.meteorologicalParameterFile.c_str());
+        exit(1);
+    }
+    if(m_weatherBank.getNumberOfHours() < numberOfHours){
+        fprintf(stderr, "error: weather bank %s holds %d hours, the maximal fire duration needs %d\n", fileName,
+                m_weatherBank.getNumberOfHours(), numberOfHours);
+        exit(1);
+    }
+    //trajectories are drawn from streams numbered over all months, so their number has to match if given
+    if(m_settings.numberOfWeatherTrajectories > 0 ?
+            m_weatherBank.getNumberOfTrajectories() != numberOfTrajectories :
+            m_weatherBank.getNumberOfTrajectories() < numberOfTrajectories){
+        fprintf(stderr, "error: weather bank %s holds %d trajectories per month, %s %d are needed\n", fileName,
+                m_weatherBank.getNumberOfTrajectories(),
+                m_settings.numberOfWeatherTrajectories > 0 ? "exactly" : "at least", numberOfTrajectories);
+        exit(1);
+    }
+}
+
+void
+Study::runScenarios(const std::string &scenarioFile)
+{
+    //one landscape burned under each scenario of the table
+    WFS_Landscape modelLandscape;
+    loadLandscape(&modelLandscape, m_settings.seed);
+    ScenarioSweep sweep;
+    sweep.importScenariosFromFile(scenarioFile);
+    sweep.runScenarios(modelLandscape, m_simulation, m_settings.seed, *m_scheduler);
+    sweep.writeSummaryToCSV("sweep_summary.csv");
+}
+
+void
+Study::runBranches(int decisionHour)
+{
+    //one fire up to the decision hour, then one branch per run and weather trajectory
+    loadWeather();
+    WFS_Landscape modelLandscape;
+    loadLandscape(&modelLandscape, m_settings.seed);
+    WeatherFork fork;
+    fork.runBranches(modelLandscape, m_simulation, m_weatherBank, decisionHour, m_settings.numberOfRuns,
+                     m_settings.seed, *m_scheduler);
+    fork.writeSummaryToCSV("fork_summary.csv");
+}
+
+bool
+Study::serveJobs(const std::string &endpoint)
+{
+    //landscape and weather stay in memory for all jobs
+    loadWeather();
+    WFS_Landscape modelLandscape;
+    loadLandscape(&modelLandscape, m_settings.seed);
+    FireSettings settings;
+    settings.timestepLength = m_settings.timestepLength;
+    settings.maximalFireDuration = m_settings.maximalFireDuration;
+    //jobs without weather use the fixed weather or the first hour of the first trajectory
+    if(m_settings.useWeatherBank){
+        m_weatherTimeline.setWeatherTrajectory(m_weatherBank, m_simulation.whichMonth, 0);
+    }
+    JobServer server{modelLandscape, settings, m_weatherTimeline.getWeather(0), m_settings.seed};
+    if(m_settings.useWeatherBank){
+        server.setWeatherBank(&m_weatherBank, m_simulation.whichMonth);
+    }
+    if(endpoint == "-"){
+        server.serveStream(0, 1, m_settings.numberOfThreads);
+        return true;
+    }
+    return server.serveSocket(endpoint, m_settings.numberOfThreads);
+}
+
+void
+Study::runBitSlicedEnsemble()
+{
+    //all runs on the same landscape, 64 fires at once
+    loadWeather();
+    WFS_Landscape modelLandscape;
+    loadLandscape(&modelLandscape, utility::deriveSeed(m_settings.seed, 0));
+    BitSlicedEnsemble fires;
+    fires.run(modelLandscape, m_weatherTimeline.getWeather(0), m_settings.timestepLength,
+              m_settings.maximalFireDuration, m_settings.numberOfRuns, m_settings.centeredIgnitionPoint,
+              m_settings.seed, m_settings.numberOfThreads);
+    fires.writeBurnProbabilityToASCII("burn_probability.asc");
+    fires.writeSummaryToCSV("ensemble_summary.csv");
+    double burnedCells = 0.0;
+    for(int cells : fires.getBurnedCells()){
+        burnedCells += cells;
+    }
+    double cellSize = modelLandscape.getCellSize();
+    printf("runs=%d meanBurnedArea=%g\n", fires.getNumberOfFires(),
+           burnedCells / std::max(fires.getNumberOfFires(), 1) * cellSize * cellSize / 10000.0);
+}
+
+void
+Study::runEnsemble()
+{
+    loadWeather();
+    const StudySettings &settings = m_settings;
+    bool resume = !settings.resumeFile.empty();
+
+    //resume from a checkpoint - the runs before the run of the checkpoint are complete
+    int firstRun = 0;
+    if(resume){
+        SimulationProgress progress;
+        if(!Checkpoint::readProgress(settings.resumeFile, &progress)){
+            fprintf(stderr, "error: %s is not a checkpoint\n", settings.resumeFile.c_str());
+            exit(1);
+        }
+        if(progress.run >= settings.numberOfRuns){
+            fprintf(stderr, "error: checkpoint of run %d, but only %d runs are simulated\n", progress.run + 1,
+                    settings.numberOfRuns);
+            exit(1);
+        }
+        firstRun = progress.run;
+    }
+
+    //burn probabilities and burned area over the runs, to stop once they are precise enough
+    EnsembleStatistics ensemble;
+    //ignition vertices and importance weights of the runs, independent of the number of runs so an
+    //ensemble extended by more runs keeps the vertices of the earlier ones
+    IgnitionSampler ignitionSampler{utility::deriveSeed(settings.seed, IgnitionSamplerStream)};
+    std::ofstream ignitionFile;
+    //flammable patches, to screen sampled ignitions
+    bool labelComponents = settings.sampledIgnitionPoint;
+    if(settings.sampledIgnitionPoint){
+        m_simulation.igniteSampledVertex = true;
+        ignitionFile.open("ignition_samples.csv");
+        ignitionFile << "run,u,v,weight" << "\n";
+    }
+
+    //the runs pass a pipeline: the landscape of a later run is prepared and the outputs of an earlier
+    //one are written while a run burns. Runs are simulated in their order, as they draw from the global
+    //random stream; with checkpoints they do not overlap, so the outputs of all runs before the run of a
+    //checkpoint are complete.
+    int numberOfPipelineRuns = settings.numberOfRuns - firstRun;
+    std::size_t numberOfSlots = !settings.checkpointFile.empty() ? 1 :
+            static_cast<std::size_t>(settings.preparationThreads + settings.writerThreads + 2);
+    std::vector<RunSlot> slots(std::min(numberOfSlots, static_cast<std::size_t>(std::max(numberOfPipelineRuns, 1))));
+    for(RunSlot &slot : slots){
+        slot.landscape.setLayout(settings.cellLayout);
+        if(!settings.landscapeCacheDirectory.empty()){
+            slot.landscape.setCacheDirectory(settings.landscapeCacheDirectory);
+        }
+        slot.simulation = m_simulation;
+    }
+
+    Pipeline pipeline;
+    pipeline.addStage("landscape", settings.preparationThreads, false, [&](std::size_t item, std::size_t s) {
+        RunSlot &slot = slots[s];
+        int i = firstRun + static_cast<int>(item);
+#ifdef WILDLAND_FIRESIM_PROFILING
+        profiling::resetProfile();
+#endif
+        // create model landscape
+        {
+            WILDLAND_PROFILE_PHASE(LandscapeLoad);
+            WILDLAND_TRACE_SPAN("landscapeLoad");
+            if(settings.importLandscape){
+                //the imported landscape is the same in all runs, only the cell states of the last fire are reset
+                if(!slot.imported){
+                    slot.landscape.importLandscapeFromFile();
+                } else {
+                    slot.landscape.resetCellStates();
+                }
+                slot.imported = true;
+            } else {
+                //every run gets its own landscape, reproducible from the seed
+                slot.landscape.generateLandscapeFromFile(settings.landscapeParameterFile,
+                                                         utility::deriveSeed(settings.seed, static_cast<unsigned int>(i)),
+                                                         settings.numberOfThreads);
+            }
+        }
+        //vegetation data before burn
+        //output.writeVegetationMapToASCII(modelLandscape, output.setfileName("vegetation_map", ".asc", i));
+        //output.writeVegetationDataToCSV(modelLandscape, output.setfileName("vegetation_data", ".csv", i));
+        if(labelComponents){
+            slot.flammableComponents.label(slot.landscape, settings.numberOfThreads);
+        }
+#ifdef WILDLAND_FIRESIM_PROFILING
+        slot.profile = profiling::currentProfile();
+#endif
+    });
+    pipeline.addStage("simulation", 1, true, [&](std::size_t item, std::size_t s) {
+        RunSlot &slot = slots[s];
+        int i = firstRun + static_cast<int>(item);
+#ifdef WILDLAND_FIRESIM_PROFILING
+        profiling::currentProfile() = slot.profile;
+#endif
+        WILDLAND_TRACE_SPAN("run");
+        //fire simulation
+        if(settings.useWeatherBank){
+            m_weatherTimeline.setWeatherTrajectory(m_weatherBank, m_simulation.whichMonth,
+                                                   i % m_weatherBank.getNumberOfTrajectories());
+        }
+        if(settings.sampledIgnitionPoint){
+            ignitionSampler.setLandscape(slot.landscape, &slot.flammableComponents, settings.minimumComponentSize);
+            slot.ignitionVertex = ignitionSampler.sample(i);
+            slot.simulation.ignitionU = slot.ignitionVertex.u;
+            slot.simulation.ignitionV = slot.ignitionVertex.v;
+            slot.ignitionWeight = ignitionSampler.getWeight();
+        }
+        slot.simulation.run = i;
+        if(resume && i == firstRun){
+            slot.simulation.resumeSimulation(&slot.landscape, &m_weatherTimeline, &slot.output, settings.resumeFile);
+        } else {
+            slot.simulation.runSimulation(&slot.landscape, &m_weatherTimeline, &slot.output);
+        }
+#ifdef WILDLAND_FIRESIM_PROFILING
+        slot.profile = profiling::currentProfile();
+#endif
+    });
+    //before the outputs are written, so no run after the one the ensemble converged with is written
+    pipeline.addStage("aggregation", 1, true, [&](std::size_t item, std::size_t s) {
+        RunSlot &slot = slots[s];
+        if(settings.sampledIgnitionPoint){
+            ignitionFile << firstRun + static_cast<int>(item) << "," << slot.ignitionVertex.u << ","
+                         << slot.ignitionVertex.v << "," << slot.ignitionWeight << "\n";
+        }
+        if(settings.ensemblePrecision > 0.f){
+            ensemble.addRun(slot.landscape, slot.ignitionWeight, slot.simulation.fire.getTouchedBounds());
+            if(ensemble.hasConverged(settings.ensemblePrecision)){
+                pipeline.stopAfter(item);
+            }
+        }
+    });
+    pipeline.addStage("output", settings.writerThreads, false, [&](std::size_t item, std::size_t s) {
+        RunSlot &slot = slots[s];
+        int i = firstRun + static_cast<int>(item);
+#ifdef WILDLAND_FIRESIM_PROFILING
+        profiling::currentProfile() = slot.profile;
+#endif
+        //creating simulation output
+        {
+            WILDLAND_PROFILE_PHASE(Output);
+            WILDLAND_TRACE_SPAN("output");
+            Output &output = slot.output;
+            if(settings.sparseOutput){
+                output.writeBurnedCellsToCSV(slot.landscape, slot.simulation.fire, output.setfileName("burned_cells", ".csv", i));
+            } else {
+                output.writeBurnMapToASCII(slot.landscape, output.setfileName("burn_map", ".asc", i ));
+                output.writeBurnDataToCSV(slot.landscape, slot.simulation.fire, output.setfileName("burndata", ".csv", i));
+            }
+            if(settings.simulateFireWeather){
+                output.writeFireWeatherDataToCSV(output.weatherData, output.setfileName("weatherdata", ".csv", i ) );
+                output.weatherData.clear();
+            }
+        }
+#ifdef WILDLAND_FIRESIM_PROFILING
+        profiling::writeReport(slot.output.setfileName("profile", ".json", i));
+#endif
+    });
+
+    //start simulation(s) and data log
+    pipeline.run(static_cast<std::size_t>(std::max(numberOfPipelineRuns, 0)), slots.size());
+    if(settings.pipelineSummary){
+        pipeline.writeStatisticsToCSV("pipeline_summary.csv");
+    }
+    if(settings.ensemblePrecision > 0.f){
+        ensemble.writeBurnProbabilityToASCII("burn_probability.asc");
+        printf("runs=%d converged=%s\n", ensemble.getNumberOfRuns(),
+               ensemble.hasConverged(settings.ensemblePrecision) ? "yes" : "no");
+        printf("burnProbabilityHalfWidth=%g\n", ensemble.getMaximumCellHalfWidth());
+        printf("meanBurnedArea=%g burnedAreaHalfWidth=%g\n", ensemble.getMeanBurnedArea(),
+               ensemble.getBurnedAreaHalfWidth());
+    }
+}
+
+}  // namespace safim
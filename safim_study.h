@@ -0,0 +1,160 @@
+#ifndef SAFIM_STUDY_H
+#define SAFIM_STUDY_H
+
+#include <memory>
+#include <string>
+#include "simulation.h"
+#include "WFS_landscape.h"
+#include "WFS_fireweather.h"
+#include "WFS_weathertimeline.h"
+#include "WFS_weatherbank.h"
+#include "WFS_ignition.h"
+#include "WFS_scheduler.h"
+
+/*!
+ * Studies of the simulator: the runs of an ensemble, scenario sweeps, branches, the job server and the
+ * bit-sliced ensemble. Unlike runFire of "safim.h" they read landscape and weather from files and
+ * write their results into the working directory. The command line program only parses its options
+ * into StudySettings and calls the study they select.
+ */
+namespace safim {
+
+using wildland_firesim::CellLayout;
+
+/*!
+ * \brief The StudySettings struct
+ * settings of a study, the options of the command line program.
+ */
+struct StudySettings {
+    //landscape, imported from the ASCII grids of the working directory or generated from a parameter file
+    bool importLandscape = false;
+    std::string landscapeParameterFile;
+    std::string landscapeCacheDirectory;
+    CellLayout cellLayout = CellLayout::RowMajor;
+
+    //fire weather, simulated, an hourly series or fixed
+    bool simulateFireWeather = false;
+    std::string meteorologicalParameterFile;
+    std::string month;
+    std::string weatherSeriesFile;
+    std::string fixedWeatherFile = "fixed_fireweather.txt";
+    //precomputed trajectories per month (0: one per run), loaded from or saved to weatherBankFile
+    bool useWeatherBank = false;
+    int numberOfWeatherTrajectories = 0;
+    std::string weatherBankFile;
+
+    //fire
+    int timestepLength = 15;          // s
+    int maximalFireDuration = 5400;   // timesteps
+    int frontSortInterval = 0;        // timesteps, 0: never
+    bool centeredIgnitionPoint = false;
+    bool sampledIgnitionPoint = false;
+    int minimumComponentSize = 0;
+    //ignition pattern file or items, empty for a single vertex
+    std::string ignition;
+
+    //runs
+    int numberOfRuns = 1;
+    unsigned int seed = 42;
+    int numberOfThreads = 1;
+    bool sparseOutput = false;
+    float ensemblePrecision = 0.f;
+    int preparationThreads = 1;
+    int writerThreads = 1;
+    bool pipelineSummary = false;
+    std::string checkpointFile;
+    int checkpointInterval = 240;
+    std::string resumeFile;
+};
+
+/*!
+ * \brief The Study class
+ * runs one of the studies with the given settings. The settings are expected to be consistent, e.g.
+ * as checked by the command line program; errors in input files end the program.
+ */
+class Study
+{
+public:
+    explicit Study(const StudySettings &settings);
+
+    Study(const Study &) = delete;
+    Study &operator=(const Study &) = delete;
+
+    /*!
+     * \brief runEnsemble
+     * simulates the runs, or continues them from the checkpoint of resumeFile, and writes the
+     * outputs of each run.
+     */
+    void runEnsemble();
+
+    /*!
+     * \brief runScenarios
+     * burns one landscape under each fixed fire weather scenario of the table and writes
+     * "sweep_summary.csv".
+     * \param scenarioFile
+     */
+    void runScenarios(const std::string &scenarioFile);
+
+    /*!
+     * \brief runBranches
+     * burns one fire until the decision hour and branches it into the weather trajectories, one
+     * branch per run, and writes "fork_summary.csv".
+     * \param decisionHour
+     */
+    void runBranches(int decisionHour);
+
+    /*!
+     * \brief serveJobs
+     * keeps the landscape in memory and serves fire jobs on a Unix domain socket, or on standard
+     * input and output if the endpoint is "-".
+     * \param endpoint
+     * \return false if the socket could not be served
+     */
+    bool serveJobs(const std::string &endpoint);
+
+    /*!
+     * \brief runBitSlicedEnsemble
+     * burns the runs on one landscape under the fixed fire weather, 64 fires at once, and writes
+     * "burn_probability.asc" and "ensemble_summary.csv".
+     */
+    void runBitSlicedEnsemble();
+
+private:
+    StudySettings m_settings;
+    //threads shared by the scenarios, branches and the spread of large fires
+    std::unique_ptr<wildland_firesim::TaskScheduler> m_scheduler;
+    //settings of the fire simulation, copied by every run
+    wildland_firesim::Simulation m_simulation;
+    wildland_firesim::IgnitionPattern m_ignitionPattern;
+    wildland_firesim::FireWeather m_weatherSimulation;
+    wildland_firesim::WeatherTimeline m_weatherTimeline;
+    wildland_firesim::WeatherTrajectoryBank m_weatherBank;
+
+    /*!
+     * \brief loadLandscape
+     * imports the landscape or generates it with the given seed, in the layout of the settings.
+     * \param landscape
+     * \param seed
+     */
+    void loadLandscape(wildland_firesim::WFS_Landscape *landscape, unsigned int seed) const;
+
+    /*!
+     * \brief loadWeather
+     * sets up the weather timeline with simulated, imported or fixed fire weather, and the weather
+     * bank if used.
+     */
+    void loadWeather();
+
+    /*!
+     * \brief checkWeatherBank
+     * ends the program if the loaded weather bank was simulated with another seed or other
+     * meteorological parameters, is shorter than the fires or holds too few trajectories.
+     * \param numberOfTrajectories trajectories per month the study needs
+     * \param numberOfHours hours the study needs
+     */
+    void checkWeatherBank(int numberOfTrajectories, int numberOfHours) const;
+};
+
+}  // namespace safim
+
+#endif // SAFIM_STUDY_H
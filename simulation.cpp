@@ -1,4 +1,6 @@
 #include "simulation.h"
+#include "WFS_profiling.h"
+#include "WFS_tracing.h"
 
 namespace wildland_firesim {
 
@@ -8,40 +10,136 @@ Simulation::Simulation()
 }
 
 void
-Simulation::runSimulation(WFS_Landscape *landscape, const FireWeatherVariables &weather,
-                          FireWeather weatherSim, Output *output)
+Simulation::runSimulation(LandscapeInterface *landscape, WeatherTimeline *weatherTimeline, Output *output)
 {
     //starting conditions
     int numberOfTimesteps = 1;
     float durationOfBurn = 0.0;
-    float nextHour = 1.0;
 
     //weather conditions at begin of fire
-    weatherSim.windyConditions = true; //at start of the fire there is wind
+    weatherTimeline->reset();
+    int weatherEpoch = 0;
+    const FireWeatherVariables *weather;
+    {
+        WILDLAND_PROFILE_PHASE(WeatherUpdate);
+        WILDLAND_TRACE_SPAN("weatherUpdate");
+        weather = &weatherTimeline->getWeather(weatherEpoch);
+        fire.setFireWeather(*weather);
+    }
     if(simulateFireWeather){
-        weatherSim.setStartingTime(12); //fires start at 12 o'clock
-        weatherSim.calculateFireWeather(whichMonth, 0);
-        output->weatherData.push_back(output->storeWeatherData(weather, durationOfBurn));
+        output->weatherData.push_back(output->storeWeatherData(*weather, durationOfBurn));
     }
 
     //igniting the fire
-    if(igniteCentralVertex){
+    if(ignitionPattern){
+        fire.initiatePrescribedBurning(landscape, *ignitionPattern);
+    } else if(igniteGivenVertex){
+        fire.setIgnitionPoint(landscape, ignitionU, ignitionV);
+    } else if(igniteSampledVertex){
+        fire.initiateWildFire(landscape, ignitionU, ignitionV);
+    } else if(igniteCentralVertex){
         fire.setCenteredIgnitionPoint(landscape);
     } else {
-        fire.initiateWildFire(landscape, weather);
+        fire.initiateWildFire(landscape);
+    }
+    m_progress = SimulationProgress();
+    m_progress.run = run;
+    m_progress.timestep = numberOfTimesteps;
+    m_progress.durationOfBurn = durationOfBurn;
+    m_progress.weatherEpoch = weatherEpoch;
+    m_progress.timestepLength = timestepLength;
+    durationOfFire = durationOfBurn;
+    if(timestepCallback && !timestepCallback(0, durationOfBurn)){
+        return;
     }
+    spread(landscape, weatherTimeline, output, m_progress);
+}
+
+void
+Simulation::resumeSimulation(LandscapeInterface *landscape, WeatherTimeline *weatherTimeline, Output *output,
+                             const std::string &fileName)
+{
+    SimulationProgress progress;
+    if(!Checkpoint::read(fileName, &progress, landscape, &fire, weatherTimeline, output)){
+        std::cerr << "invalid checkpoint: " << fileName << " does not fit the landscape\n";
+        std::exit(1);
+    }
+    if(progress.timestepLength != timestepLength){
+        std::cerr << "invalid checkpoint: " << fileName << " was written with a timestep length of "
+                  << progress.timestepLength << " s\n";
+        std::exit(1);
+    }
+    run = progress.run;
+    spread(landscape, weatherTimeline, output, progress);
+}
+
+SimulationSnapshot
+Simulation::takeSnapshot(TiledLandscape *landscape, const Output &output) const
+{
+    landscape->share();
+    return SimulationSnapshot{m_progress, landscape->fork(), fire, output.weatherData};
+}
+
+void
+Simulation::continueFromSnapshot(const SimulationSnapshot &snapshot, TiledLandscape *landscape,
+                                 WeatherTimeline *weatherTimeline, Output *output)
+{
+    WILDLAND_ASSERT(snapshot.progress.timestepLength == timestepLength,
+                    "the snapshot was taken with another timestep length");
+    *landscape = snapshot.landscape.fork();
+    utility::RandomStream *random = fire.getRandomStream();
+    fire = snapshot.fire;
+    fire.setRandomStream(random);
+    output->weatherData = snapshot.weatherData;
+    run = snapshot.progress.run;
+    spread(landscape, weatherTimeline, output, snapshot.progress);
+}
+
+void
+Simulation::spread(LandscapeInterface *landscape, WeatherTimeline *weatherTimeline, Output *output,
+                   SimulationProgress progress)
+{
+    int numberOfTimesteps = progress.timestep;
+    float durationOfBurn = progress.durationOfBurn;
+    int weatherEpoch = progress.weatherEpoch;
+    bool proceed = true;
 
     //simulate fire spread
-    while((fire.numberOfCellsBurning != 0) && (numberOfTimesteps < maxFireDuration)){
-        if(simulateFireWeather && durationOfBurn >= nextHour){
-            weatherSim.calculateFireWeather(whichMonth, static_cast<int>(std::floor(durationOfBurn)));
-            output->weatherData.push_back(output->storeWeatherData(weather, durationOfBurn));
-            nextHour = std::floor(durationOfBurn+1);
+    while(proceed && (fire.numberOfCellsBurning != 0) && (numberOfTimesteps < maxFireDuration)){
+        WILDLAND_TRACE_SPAN("timestep");
+        //the fire weather only changes at the begin of an hour
+        int currentEpoch = WeatherTimeline::getEpoch(durationOfBurn);
+        if(currentEpoch != weatherEpoch){
+            WILDLAND_PROFILE_PHASE(WeatherUpdate);
+            WILDLAND_TRACE_SPAN("weatherUpdate");
+            weatherEpoch = currentEpoch;
+            const FireWeatherVariables &weather = weatherTimeline->getWeather(weatherEpoch);
+            fire.setFireWeather(weather);
+            if(simulateFireWeather){
+                output->weatherData.push_back(output->storeWeatherData(weather, durationOfBurn));
+            }
         }
-        fire.spreadFire(landscape, weather, timestepLength);
+        fire.spreadFire(landscape, timestepLength);
         durationOfBurn = (numberOfTimesteps * timestepLength)/(60.f*60.f);
+        if(timestepCallback){
+            proceed = timestepCallback(numberOfTimesteps, durationOfBurn);
+        }
         numberOfTimesteps++;
+
+        if(checkpointInterval > 0 && numberOfTimesteps % checkpointInterval == 0){
+            progress.timestep = numberOfTimesteps;
+            progress.durationOfBurn = durationOfBurn;
+            progress.weatherEpoch = weatherEpoch;
+            if(!Checkpoint::write(checkpointFileName, progress, landscape, fire, *weatherTimeline, *output)){
+                std::cerr << "warning: checkpoint could not be written to " << checkpointFileName << "\n";
+            }
+        }
     }
+    m_progress = progress;
+    m_progress.timestep = numberOfTimesteps;
+    m_progress.durationOfBurn = durationOfBurn;
+    m_progress.weatherEpoch = weatherEpoch;
+    durationOfFire = durationOfBurn;
 }
 
 
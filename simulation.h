@@ -1,16 +1,34 @@
 #ifndef WILDLAND_FIRESIM_SIMULATION_H
 #define WILDLAND_FIRESIM_SIMULATION_H
 
+#include <functional>
 #include <iostream>
 #include <string>
 #include "utility.h"
 #include "globals.h"
 #include "WFS_landscape.h"
 #include "WFS_fireweather.h"
+#include "WFS_weathertimeline.h"
 #include "fire.h"
 #include "WFS_output.h"
+#include "WFS_checkpoint.h"
+#include "WFS_tiledlandscape.h"
+#include "WFS_ignition.h"
 
 namespace wildland_firesim{
+
+/*!
+ * \brief The SimulationSnapshot struct
+ * state of a stopped fire from which any number of branches can continue. The landscape shares
+ * its tiles with the branches.
+ */
+struct SimulationSnapshot {
+    SimulationProgress progress;
+    TiledLandscape landscape;
+    Fire fire;
+    std::vector<std::string> weatherData;
+};
+
 /*!
  * \brief The Simulation class
  * contains function to simulate fire within a landscape either with static weather conditions or a
@@ -25,28 +43,100 @@ public:
 
     /*!
      * \brief runSimulation
-     * runs the simulation and logs output data.
+     * runs the simulation and logs output data. The fire weather is taken from the weather
+     * timeline and handed to the fire once per hourly epoch.
      * \param landscape
-     * \param weather
+     * \param weatherTimeline
+     * \param output
+     */
+    void runSimulation(LandscapeInterface *landscape, WeatherTimeline *weatherTimeline, Output *output);
+
+    /*!
+     * \brief resumeSimulation
+     * continues a fire from a checkpoint. Landscape and weather timeline have to be set up as for
+     * the run of the checkpoint; the random stream of the fire is restored.
+     * \param landscape unburned landscape of the run
+     * \param weatherTimeline
+     * \param output
+     * \param fileName checkpoint file
+     */
+    void resumeSimulation(LandscapeInterface *landscape, WeatherTimeline *weatherTimeline, Output *output,
+                          const std::string &fileName);
+
+    /*!
+     * \brief takeSnapshot
+     * takes a snapshot of the fire after it was stopped by the timestep callback. The landscape
+     * stays usable and shares its tiles with the snapshot.
+     * \param landscape the landscape of the fire
+     * \param output stored fire weather of the fire
+     * \return
+     */
+    SimulationSnapshot takeSnapshot(TiledLandscape *landscape, const Output &output) const;
+
+    /*!
+     * \brief continueFromSnapshot
+     * continues a branch of the fire of a snapshot on a fork of its landscape. The fire keeps its
+     * random stream; the weather timeline provides the weather from the epoch of the snapshot on.
+     * Branches of one snapshot can be continued in parallel.
+     * \param snapshot
+     * \param landscape is replaced by a fork of the landscape of the snapshot
+     * \param weatherTimeline
      * \param output
      */
-    void runSimulation(WFS_Landscape *landscape, const FireWeatherVariables &weather,
-                       FireWeather weathersim, Output *output);
+    void continueFromSnapshot(const SimulationSnapshot &snapshot, TiledLandscape *landscape,
+                              WeatherTimeline *weatherTimeline, Output *output);
+
+    /*!
+     * \brief timestepCallback
+     * is called, if set, after the ignition (timestep 0) and after each timestep with the number of
+     * the timestep and the duration of the fire in hours. Returning false stops the fire.
+     */
+    std::function<bool(int, float)> timestepCallback;
 
     int numberOfRuns;
     int maxFireDuration;
     bool simulateFireWeather;
     bool importLandscape;
     bool igniteCentralVertex;
+    //ignite the vertex (ignitionU, ignitionV) instead of the central or a random one
+    bool igniteGivenVertex = false;
+    int ignitionU = 0;
+    int ignitionV = 0;
+    //ignite (ignitionU, ignitionV) like a random wild fire, depending on fuel and weather, e.g. a
+    //vertex of an IgnitionSampler
+    bool igniteSampledVertex = false;
+    //light all vertices of the pattern at once instead of a single vertex, if set
+    const IgnitionPattern *ignitionPattern = nullptr;
     Month whichMonth;
 
     int timestepLength;
     float timeScalingFactor;
 
+    //write a checkpoint of the fire to checkpointFileName every checkpointInterval timesteps (0: never)
+    int checkpointInterval = 0;
+    std::string checkpointFileName;
+    //index of the current run, stored in checkpoints
+    int run = 0;
+
+    //duration of the last simulated fire in hours
+    float durationOfFire;
+
     std::string nameOfMeteorologicalParameterFile;
     std::string nameOfLandscapeParameterFile;
 
     Fire fire;
+
+private:
+    //progress of the last fire, where it continues if it was stopped
+    SimulationProgress m_progress;
+
+    /*!
+     * \brief spread
+     * simulates the fire from the given progress until it is extinguished, stopped by the
+     * timestep callback or reaches the maximal fire duration.
+     */
+    void spread(LandscapeInterface *landscape, WeatherTimeline *weatherTimeline, Output *output,
+                SimulationProgress progress);
 };
 
 }  // namespace wildland_firesim
@@ -1,10 +1,86 @@
 #include "utility.h"
+#include <cstdint>
 #include <iostream>
-#include <random>
+#include <sstream>
 
 namespace wildland_firesim {
 namespace utility {
 
+RandomStream::RandomStream(unsigned int seed)
+    : m_engine{seed}, m_distribution{0.f, 1.f}
+{}
+
+RandomStream::RandomStream(unsigned int seed, unsigned int streamId)
+    : m_engine{}, m_distribution{0.f, 1.f}
+{
+    std::seed_seq sequence{seed, streamId};
+    m_engine.seed(sequence);
+}
+
+float
+RandomStream::random()
+{
+    return m_distribution(m_engine);
+}
+
+int
+RandomStream::random(int top)
+{
+    auto distribution = std::uniform_int_distribution<int>{0, top};
+    return distribution(m_engine);
+}
+
+float
+RandomStream::random(float min, float max)
+{
+    auto distribution = std::uniform_real_distribution<float>{min, max};
+    return distribution(m_engine);
+}
+
+float
+RandomStream::normal_random(float mean, float sd)
+{
+    auto distribution = std::normal_distribution<float>{mean, sd};
+    return distribution(m_engine);
+}
+
+float
+RandomStream::weibull_random(float shape, float form)
+{
+    auto distribution = std::weibull_distribution<float>{shape, form};
+    return distribution(m_engine);
+}
+
+std::vector<std::uint32_t>
+RandomStream::getState() const
+{
+    //the standard only defines the textual representation of the engine state
+    std::stringstream text;
+    text << m_engine;
+    std::vector<std::uint32_t> state;
+    std::uint32_t word;
+    while(text >> word){
+        state.push_back(word);
+    }
+    return state;
+}
+
+bool
+RandomStream::setState(const std::vector<std::uint32_t> &state)
+{
+    std::stringstream text;
+    for(std::uint32_t word : state){
+        text << word << ' ';
+    }
+    std::mt19937 engine;
+    text >> engine;
+    if(text.fail()){
+        return false;
+    }
+    m_engine = engine;
+    return true;
+}
+
 class RandomNumberGenerator {
 
 public:
@@ -17,48 +93,103 @@ public:
         return s_instance;
     }
 
-    float random()
+    RandomStream &stream()
     {
-        return m_distribution(m_engine);
+        return m_stream;
     }
 
-    int random(int top)
-    {
-        auto distribution = std::uniform_int_distribution<int>{0, top};
-        return distribution(m_engine);
-    }
+private:
+    static constexpr unsigned int fixedSeed = 42; //fixed seed for sensitivity analysis
+    static RandomNumberGenerator *s_instance;
+    //RandomNumberGenerator() : m_stream{std::random_device{}()} {}
+    RandomNumberGenerator() : m_stream{fixedSeed} {}
+    RandomStream m_stream;
+};
 
-    float random(float min, float max)
-    {
-        auto distribution = std::uniform_real_distribution<float>{min, max};
-        return distribution(m_engine);
-    }
+RandomNumberGenerator *RandomNumberGenerator::s_instance;
 
-    float normal_random(float mean, float sd)
-    {
-        auto distribution = std::normal_distribution<float>{mean, sd};
-        return distribution(m_engine);
-    }
+unsigned int
+deriveSeed(unsigned int seed, unsigned int streamId)
+{
+    std::seed_seq sequence{seed, streamId};
+    std::uint32_t derivedSeed;
+    sequence.generate(&derivedSeed, &derivedSeed + 1);
+    return derivedSeed;
+}
 
-    float weibull_random(float shape, float form)
-    {
-        auto distribution = std::weibull_distribution<float>{shape, form};
-        return distribution(m_engine);
+RandomStream &
+globalRandomStream()
+{
+    return RandomNumberGenerator::getInstance()->stream();
+}
+
+AliasTable::AliasTable() : m_probability(), m_alias()
+{}
+
+bool
+AliasTable::build(const std::vector<float> &weights)
+{
+    size_t n = weights.size();
+    double sum = 0.0;
+    for(float weight : weights){
+        if(weight > 0.f) sum += weight;
+    }
+    if(n == 0 || sum <= 0.0){
+        return false;
     }
 
-private:
-    int fixedSeed = 42; //fixed seed for sensitivity analysis
-    static RandomNumberGenerator *s_instance;
-    //RandomNumberGenerator() : m_engine{rd()}, m_distribution{0.f, 1.f} {}
-    RandomNumberGenerator() : m_engine{fixedSeed}, m_distribution{0.f, 1.f} {}
-    std::random_device rd;
-    std::mt19937 m_engine;
-    std::uniform_real_distribution<float> m_distribution;
-    std::normal_distribution<float> m_normalDistribution;
-    std::weibull_distribution<float> m_weibullDistribution;
-};
+    m_probability.assign(n, 0.f);
+    m_alias.assign(n, 0);
+
+    //scale weights so that the mean probability is one and split them into under- and overfull columns
+    std::vector<double> scaled(n);
+    std::vector<size_t> small;
+    std::vector<size_t> large;
+    for(size_t i = 0; i < n; i++){
+        scaled[i] = (weights[i] > 0.f ? weights[i] : 0.0) * static_cast<double>(n) / sum;
+        if(scaled[i] < 1.0){
+            small.push_back(i);
+        } else {
+            large.push_back(i);
+        }
+    }
+    //fill each underfull column with the excess of an overfull one
+    while(!small.empty() && !large.empty()){
+        size_t l = small.back();
+        small.pop_back();
+        size_t g = large.back();
+        large.pop_back();
+        m_probability[l] = static_cast<float>(scaled[l]);
+        m_alias[l] = static_cast<int>(g);
+        scaled[g] = (scaled[g] + scaled[l]) - 1.0;
+        if(scaled[g] < 1.0){
+            small.push_back(g);
+        } else {
+            large.push_back(g);
+        }
+    }
+    //remaining columns are full apart from rounding errors
+    for(size_t i : large){
+        m_probability[i] = 1.f;
+        m_alias[i] = static_cast<int>(i);
+    }
+    for(size_t i : small){
+        m_probability[i] = 1.f;
+        m_alias[i] = static_cast<int>(i);
+    }
+    return true;
+}
 
-RandomNumberGenerator *RandomNumberGenerator::s_instance;
+int
+AliasTable::sample(RandomStream &random) const
+{
+    WILDLAND_ASSERT(!m_probability.empty(), "alias table is not initialized");
+    int column = random.random(static_cast<int>(m_probability.size()) - 1);
+    if(random.random() < m_probability[static_cast<size_t>(column)]){
+        return column;
+    }
+    return m_alias[static_cast<size_t>(column)];
+}
 
 void _assert(bool condition, const char *message)
 {
@@ -70,26 +201,26 @@ void _assert(bool condition, const char *message)
 
 float random()
 {
-    return RandomNumberGenerator::getInstance()->random();
+    return globalRandomStream().random();
 }
 
 int random(int top)
 {
-    return RandomNumberGenerator::getInstance()->random(top);
+    return globalRandomStream().random(top);
 }
 float random(float min, float max)
 {
-    return RandomNumberGenerator::getInstance()->random(min, max);
+    return globalRandomStream().random(min, max);
 }
 
 float normal_random(float mean, float sd)
 {
-    return RandomNumberGenerator::getInstance()->normal_random(mean, sd);
+    return globalRandomStream().normal_random(mean, sd);
 }
 
 float weibull_random(float scale, float form)
 {
-    return RandomNumberGenerator::getInstance()->weibull_random(scale, form);
+    return globalRandomStream().weibull_random(scale, form);
 }
 
 float asFloat(const std::string &str)
@@ -7,14 +7,95 @@
 #define WILDLAND_ASSERT(c, m)
 #endif
 
+#include <cstdint>
 #include <string>
 #include <cstdlib>
+#include <random>
+#include <vector>
 
 namespace wildland_firesim {
 namespace utility {
 
 void _assert(bool condition, const char *message);
 
+/*!
+ * \brief The RandomStream class
+ * is an independent stream of pseudo-random numbers. Streams seeded with a seed and a stream id
+ * are reproducible regardless of the order or the thread they are used in. The free functions
+ * below draw from the global stream.
+ */
+class RandomStream
+{
+public:
+    explicit RandomStream(unsigned int seed);
+    RandomStream(unsigned int seed, unsigned int streamId);
+
+    float random();
+    int random(int top);
+    float random(float min, float max);
+    float normal_random(float mean, float sd);
+    float weibull_random(float shape, float form);
+
+    /*!
+     * \brief getState
+     * returns the state of the engine, e.g. to continue the stream after a restart.
+     * \return
+     */
+    std::vector<std::uint32_t> getState() const;
+
+    /*!
+     * \brief setState
+     * continues the stream from a state returned by getState.
+     * \param state
+     * \return false if the state is invalid
+     */
+    bool setState(const std::vector<std::uint32_t> &state);
+
+private:
+    std::mt19937 m_engine;
+    std::uniform_real_distribution<float> m_distribution;
+};
+
+/*!
+ * \brief deriveSeed
+ * returns a seed for an independent stream, e.g. of a single model run, from a base seed.
+ * \param seed
+ * \param streamId
+ * \return
+ */
+unsigned int deriveSeed(unsigned int seed, unsigned int streamId);
+
+/*!
+ * \brief globalRandomStream
+ * returns the stream used by the free random functions.
+ * \return
+ */
+RandomStream &globalRandomStream();
+
+/*!
+ * \brief The AliasTable class
+ * samples an index of a discrete distribution in constant time using the alias method by Vose (1991).
+ */
+class AliasTable
+{
+public:
+    AliasTable();
+
+    /*!
+     * \brief build
+     * prepares the table for the given (not necessarily normalized) weights.
+     * \param weights
+     * \return false if no weight is positive
+     */
+    bool build(const std::vector<float> &weights);
+
+    int sample(RandomStream &random) const;
+
+private:
+    std::vector<float> m_probability;
+    std::vector<int> m_alias;
+};
+
 /*!
  * \brief random
  * returns a pseudo-random float in [0..1)
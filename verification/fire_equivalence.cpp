@@ -0,0 +1,318 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "fire.h"
+#include "reference_fire.h"
+#include "WFS_allocations.h"
+#include "WFS_scheduler.h"
+
+/*! \file
+ * Equivalence check of the optimized fire spread engine (Fire) against the frozen scalar engine
+ * (ReferenceFire). Both engines burn the same seeded synthetic landscapes under the same hourly
+ * weather and draw from identically seeded random streams. Burn maps, ignition timesteps and burn
+ * durations of every cell have to be equal, fireline intensities have to agree within the given
+ * tolerances. The program exits with 1 if any case differs.
+ */
+
+using namespace ::wildland_firesim;
+
+static const char *progname = nullptr;
+
+static int numberOfCases = 100;
+static unsigned int seed = 42;
+static int maximalLandscapeSize = 120;
+static int maximalFireDuration = 2000;
+static int timestepLength = 15;
+static float relativeTolerance = 1e-5f;
+static float absoluteTolerance = 1e-3f;
+static int numberOfThreads = 1;
+static int parallelSpreadMinimumCells = 8192;
+
+namespace {
+
+/*!
+ * \brief The GridLandscape class
+ * synthetic landscape of random vegetation.
+ */
+class GridLandscape : public LandscapeInterface
+{
+public:
+    GridLandscape(utility::RandomStream &random, int maximalSize)
+    {
+        m_width = 10 + random.random(maximalSize - 9);
+        m_height = 10 + random.random(maximalSize - 9);
+        m_cellSize = 10 + random.random(41);
+        float shareNonFlammable = random.random(0.f, 0.3f);
+        float curing = random.random(0.3f, 1.f);
+        m_cells.resize(static_cast<size_t>(m_width) * m_height);
+        for(Cell &cell : m_cells){
+            cell.type = random.random() < shareNonFlammable ? VegetationType::NonFlammable : VegetationType::Grass;
+            float fuelLoad = random.random(100.f, 600.f);
+            float cellCuring = std::min(1.f, curing + random.random(-0.1f, 0.1f));
+            cell.deadBiomass = fuelLoad * cellCuring;
+            cell.liveBiomass = fuelLoad - cell.deadBiomass;
+            cell.setState(CellState::Unburned, getStateEpoch());
+        }
+    }
+
+    int getWidth() const noexcept override { return m_width; }
+    int getHeight() const noexcept override { return m_height; }
+    int getCellSize() const noexcept override { return m_cellSize; }
+    Cell *getCellInformation(int x, int y) override
+    {
+        return &m_cells[static_cast<size_t>(y) * m_width + x];
+    }
+
+private:
+    int m_width;
+    int m_height;
+    int m_cellSize;
+    std::vector<Cell> m_cells;
+};
+
+/*!
+ * \brief The FireRecord struct
+ * rasters of a fire: ignition timestep, number of timesteps burning and last mean fireline intensity
+ * of each cell.
+ */
+struct FireRecord {
+    std::vector<CellState> state;
+    std::vector<int> ignitionStep;
+    std::vector<int> burningSteps;
+    std::vector<float> intensity;
+    int steps = 0;
+
+    explicit FireRecord(size_t numberOfCells)
+        : state(numberOfCells), ignitionStep(numberOfCells, -1), burningSteps(numberOfCells, 0),
+          intensity(numberOfCells, 0.f)
+    {
+    }
+
+    template<typename BurningCells>
+    void recordStep(const BurningCells &burningCells, int width, int step)
+    {
+        for(const auto &burningCell : burningCells){
+            size_t index = static_cast<size_t>(burningCell.yCoord) * width + burningCell.xCoord;
+            if(ignitionStep[index] < 0) ignitionStep[index] = step;
+            burningSteps[index]++;
+            intensity[index] = burningCell.meanFirelineIntensity;
+        }
+    }
+};
+
+/*!
+ * \brief runFire
+ * burns the landscape like Simulation::runSimulation. Spread is given the weather of the current
+ * hour and returns the burning cells.
+ */
+template<typename Ignite, typename Spread, typename Burning>
+FireRecord
+runFire(GridLandscape landscape, const std::vector<FireWeatherVariables> &hourlyWeather,
+        Ignite ignite, Spread spread, Burning burning)
+{
+    FireRecord record{static_cast<size_t>(landscape.getWidth()) * landscape.getHeight()};
+    int numberOfTimesteps = 1;
+    float durationOfBurn = 0.0;
+    ignite(&landscape, hourlyWeather[0]);
+    record.recordStep(burning(), landscape.getWidth(), 0);
+    while(!burning().empty() && numberOfTimesteps < maximalFireDuration){
+        size_t hour = std::min(hourlyWeather.size() - 1, static_cast<size_t>(std::floor(durationOfBurn)));
+        spread(&landscape, hourlyWeather[hour]);
+        record.recordStep(burning(), landscape.getWidth(), numberOfTimesteps);
+        durationOfBurn = (numberOfTimesteps * timestepLength)/(60.f*60.f);
+        numberOfTimesteps++;
+    }
+    record.steps = numberOfTimesteps;
+    for(int y = 0; y < landscape.getHeight(); y++)
+        for(int x = 0; x < landscape.getWidth(); x++)
+            record.state[static_cast<size_t>(y) * landscape.getWidth() + x] = landscape.getCellInformation(x, y)->getState(landscape.getStateEpoch());
+    return record;
+}
+
+/*!
+ * \brief compareRecords
+ * \return number of cells differing between the engines
+ */
+int
+compareRecords(const FireRecord &reference, const FireRecord &optimized)
+{
+    int differences = 0;
+    for(size_t i = 0; i < reference.state.size(); i++){
+        float tolerance = absoluteTolerance + relativeTolerance *
+                std::max(std::abs(reference.intensity[i]), std::abs(optimized.intensity[i]));
+        if(reference.state[i] != optimized.state[i] ||
+                reference.ignitionStep[i] != optimized.ignitionStep[i] ||
+                reference.burningSteps[i] != optimized.burningSteps[i] ||
+                std::abs(reference.intensity[i] - optimized.intensity[i]) > tolerance){
+            differences++;
+        }
+    }
+    return differences;
+}
+
+[[noreturn]] void
+usage()
+{
+    fprintf(stderr, "usage: %s OPTIONS\n", progname);
+    fprintf(stderr, "Equivalence check of the fire spread engine against the reference engine\n\nOptions:\n");
+    fprintf(stderr, "\t-h\tDisplays this help.\n");
+    fprintf(stderr, "\t-n <number-of-cases>\tNumber of seeded landscapes and weather series.\n");
+    fprintf(stderr, "\t-g <seed>\tSeed of the cases.\n");
+    fprintf(stderr, "\t-s <maximal-size>\tMaximal width and height of the landscapes in cells.\n");
+    fprintf(stderr, "\t-d <maximal-fire-duration>\tMaximal duration of the fires (timesteps).\n");
+    fprintf(stderr, "\t-t <timestep-length>\tLength of timesteps.\n");
+    fprintf(stderr, "\t-r <tolerance>\tRelative tolerance of fireline intensities.\n");
+    fprintf(stderr, "\t-a <tolerance>\tAbsolute tolerance of fireline intensities (kJ/s/m).\n");
+    fprintf(stderr, "\t-j <number-of-threads>\tThreads spreading large fires within their cells.\n");
+    fprintf(stderr, "\t-p <cells>\tBurning cells from which fires spread within their cells in parallel.\n");
+    exit(1);
+}
+
+void
+parseArguments(int argc, char *argv[])
+{
+    progname = argv[0];
+
+    while (argc > 1 && argv[1][0] == '-') {
+        if (argc < 3)
+            usage();
+        switch (argv[1][1]) {
+        case 'h':
+        default:
+            usage();
+        case 'n':
+            numberOfCases = atoi(argv[2]);
+            break;
+        case 'g':
+            seed = static_cast<unsigned int>(strtoul(argv[2], nullptr, 10));
+            break;
+        case 's':
+            maximalLandscapeSize = atoi(argv[2]);
+            break;
+        case 'd':
+            maximalFireDuration = atoi(argv[2]);
+            break;
+        case 't':
+            timestepLength = atoi(argv[2]);
+            break;
+        case 'r':
+            relativeTolerance = static_cast<float>(atof(argv[2]));
+            break;
+        case 'a':
+            absoluteTolerance = static_cast<float>(atof(argv[2]));
+            break;
+        case 'j':
+            numberOfThreads = atoi(argv[2]);
+            break;
+        case 'p':
+            parallelSpreadMinimumCells = atoi(argv[2]);
+            break;
+        }
+        argc -= 2;
+        argv += 2;
+    }
+    if (numberOfCases < 1 || maximalLandscapeSize < 10 || timestepLength < 1 || numberOfThreads < 1
+            || parallelSpreadMinimumCells < 1)
+        usage();
+}
+
+}
+
+int main(int argc, char *argv[])
+{
+    parseArguments(argc, argv);
+
+    int numberOfHours = maximalFireDuration * timestepLength / (60 * 60) + 1;
+    //with -j, fires of at least -p burning cells spread within their cells in parallel
+    TaskScheduler scheduler{numberOfThreads};
+    int failedCases = 0;
+    long long burnedCells = 0;
+    for (int i = 0; i < numberOfCases; i++) {
+        unsigned int caseSeed = utility::deriveSeed(seed, static_cast<unsigned int>(i));
+        utility::RandomStream random{caseSeed, 0};
+        GridLandscape landscape{random, maximalLandscapeSize};
+        //every second case has constant weather, the others change the weather every hour
+        std::vector<FireWeatherVariables> hourlyWeather(static_cast<size_t>(i % 2 == 0 ? 1 : numberOfHours));
+        for (FireWeatherVariables &weather : hourlyWeather) {
+            weather.temperature = random.random(10.f, 40.f);
+            weather.relHumidity = random.random(5.f, 60.f);
+            weather.windSpeed = random.random() < 0.2f ? 0.f : random.random(0.f, 10.f);
+            weather.windDirection = 1 + random.random(8);
+        }
+        bool centered = i % 4 < 2;
+
+        utility::RandomStream referenceRandom{caseSeed, 1};
+        ReferenceFire referenceFire{&referenceRandom};
+        FireRecord reference = runFire(landscape, hourlyWeather,
+            [&](LandscapeInterface *l, const FireWeatherVariables &weather) {
+                if (centered)
+                    referenceFire.setCenteredIgnitionPoint(l);
+                else
+                    referenceFire.initiateWildFire(l, weather);
+            },
+            [&](LandscapeInterface *l, const FireWeatherVariables &weather) {
+                referenceFire.spreadFire(l, weather, timestepLength);
+            },
+            [&]() -> const std::vector<ReferenceFire::burningCellInformation> & {
+                return referenceFire.burningCellInformationVector;
+            });
+
+        utility::RandomStream optimizedRandom{caseSeed, 1};
+        Fire fire;
+        fire.setRandomStream(&optimizedRandom);
+        fire.setTaskScheduler(&scheduler);
+        fire.setParallelSpreadMinimumCells(static_cast<size_t>(parallelSpreadMinimumCells));
+        const FireWeatherVariables *currentWeather = nullptr;
+        auto burnOptimized = [&]() {
+            return runFire(landscape, hourlyWeather,
+                [&](LandscapeInterface *l, const FireWeatherVariables &weather) {
+                    currentWeather = &weather;
+                    fire.setFireWeather(weather);
+                    if (centered)
+                        fire.setCenteredIgnitionPoint(l);
+                    else
+                        fire.initiateWildFire(l);
+                },
+                [&](LandscapeInterface *l, const FireWeatherVariables &weather) {
+                    //a new weather epoch starts when the hour changes
+                    if (&weather != currentWeather) {
+                        currentWeather = &weather;
+                        fire.setFireWeather(weather);
+                    }
+                    fire.spreadFire(l, timestepLength);
+                },
+                [&]() -> const std::vector<Fire::burningCellInformation> & {
+                    return fire.burningCellInformationVector;
+                });
+        };
+        FireRecord optimized = burnOptimized();
+
+        int differences = compareRecords(reference, optimized);
+        if (differences > 0 || reference.steps != optimized.steps) {
+            fprintf(stderr, "case %d (seed %u, %dx%d cells, %s ignition): %d cells differ, %d vs %d timesteps\n",
+                    i, caseSeed, landscape.getWidth(), landscape.getHeight(), centered ? "centered" : "random",
+                    differences, reference.steps, optimized.steps);
+            failedCases++;
+        }
+#ifdef WILDLAND_FIRESIM_ALLOCATION_CHECK
+        //the same fire burned again may only use memory kept from the first fire
+        optimizedRandom = utility::RandomStream{caseSeed, 1};
+        allocations::resetCount();
+        burnOptimized();
+        if (allocations::countInScopes() > 0) {
+            fprintf(stderr, "case %d (seed %u): %lld heap allocations within timesteps of the repeated fire\n",
+                    i, caseSeed, allocations::countInScopes());
+            failedCases++;
+        }
+#endif
+        burnedCells += std::count_if(reference.ignitionStep.begin(), reference.ignitionStep.end(),
+                                     [](int step) { return step >= 0; });
+    }
+
+    printf("%d of %d cases equivalent (%lld cells burned by the reference engine)\n",
+           numberOfCases - failedCases, numberOfCases, burnedCells);
+    return failedCases > 0 ? 1 : 0;
+}
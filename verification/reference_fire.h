@@ -0,0 +1,76 @@
+#ifndef WILDLAND_FIRESIM_REFERENCE_FIRE_H
+#define WILDLAND_FIRESIM_REFERENCE_FIRE_H
+
+#include <vector>
+#include "fire.h"
+#include "landscape_interface.h"
+#include "utility.h"
+
+namespace wildland_firesim {
+
+/*!
+ * \brief The ReferenceFire class
+ * is the scalar fire spread engine as released in version 1.0, kept frozen as the reference for the
+ * equivalence checks of the optimized Fire. The only changes are that the weather is passed per
+ * timestep, the random draws come from a given stream and a wild fire ignition sets the mean fireline
+ * intensity of the cell before storing it (version 1.0 stored it uninitialized). Do not optimize
+ * this class.
+ */
+class ReferenceFire
+{
+public:
+    explicit ReferenceFire(utility::RandomStream *random);
+
+    void spreadFire(LandscapeInterface *landscape, const FireWeatherVariables &weather, int timestepLength);
+
+    void initiateWildFire(LandscapeInterface *landscape, const FireWeatherVariables &weather);
+
+    void setCenteredIgnitionPoint(LandscapeInterface *landscape);
+
+    struct burningCellInformation{
+        int xCoord;
+        int yCoord;
+        int uCoordSource;
+        int vCoordSource;
+        float meanFirelineIntensity;
+        std::vector<float> burnStatus;
+        std::vector<int> spreadDirection;
+    };
+
+    std::vector<burningCellInformation> burningCellInformationVector;
+
+    float distance_to_cell_boundary[3];
+    int numberOfCellsBurning;
+
+private:
+    int heatYield = 17000;
+    utility::RandomStream *m_random;
+
+    struct pointFireSourceInformation{
+        int uCoord;
+        int vCoord;
+        int remainingTime;
+        float fireIntensity;
+    };
+
+    float calculateHeadFireRateOfSpread(const float fuelload, const float moistureContent,
+                                        const float relHumidity, const float windspeed);
+
+    float calculateDirectionalRateOfSpread(const float windSpeed, const int windDirection,
+                                           const float headFireRateOfSpread, const int directionOfFireSpread);
+
+    float estimateGrassFuelMoisture(const float temperature, const float relativeHumidity,
+                                    const float curing);
+
+    float estimateFuelAvailability(const float grassMoistureContent);
+
+    float calculateFirelineIntensity(const float rateOfSpread, const float availableFuelLoad);
+
+    float calculateCellIgnitionProbability(const float intensity, const float moistureContent);
+
+    float calculateInitialIgnitionProbability(const float grassFuelMoisture);
+};
+
+}  // namespace wildland_firesim
+
+#endif // WILDLAND_FIRESIM_REFERENCE_FIRE_H